@@ -3,8 +3,13 @@
 #ifndef _BACKTRACK_H_INCLUDED
 #define _BACKTRACK_H_INCLUDED
 
+#include <iostream>
 #include <vector>
 #include <stack>
+#include <cstdint>
+
+#include "search_limits.h"
+#include "search_stats.h"
 
 template <typename ElemType>
 class Strategy {
@@ -16,6 +21,14 @@ class Strategy {
 		virtual bool is_solution(const std::vector<ElemType>& soln) const = 0;
 		// returns true of soln is a solution to the problem, false otherwise
 
+		virtual void on_push(const ElemType&) {}
+		// called right after an element is appended to the partial solution, before is_solution and
+		// get_candidates see it.  Lets a strategy keep incremental state (sums, used sets, counters)
+		// instead of rescanning the partial solution at every node.  The default does nothing.
+
+		virtual void on_pop(const ElemType&) {}
+		// called right after an element is removed from the end of the partial solution, undoes its on_push
+
 		virtual ~Strategy() {}
 };
 
@@ -27,13 +40,24 @@ class Accumulator {
 		virtual void operator()(const std::vector<ElemType>& soln) = 0;
 		// this is the 'accumulate' function
 
+		virtual search_control accumulate(const std::vector<ElemType>& soln)
+		{
+			(*this)(soln);
+			return search_control::proceed;
+		}
+		// what the engines call for each solution, the answer tells whether the search goes on.  The
+		// default hands soln to operator() and proceeds; override it to stop after the first k solutions,
+		// or as soon as a solution satisfies some predicate.
+
 		virtual ~Accumulator() {}
 };
 
 // TODO: The 'verbose' flag in backtrack class needs some thought.  Don't depend on std::cout for example.
 // TODO: Unify the logging (verbose) for all classes concerned (backtrack, Strategy and Accumulator).
 // TODO: Remove the function call operator in favor of a named function.  Readability wins.
-template <typename ElemType>
+// StatsType is a statistics policy (search_stats.h), depth_search_stats to see where the search spends
+// its nodes and time, the default no_search_stats costs nothing.
+template <typename ElemType, typename StatsType = no_search_stats>
 class backtrack {
 	public:
 		backtrack(Strategy<ElemType>& strat, Accumulator<ElemType>& accum, int solution_length);
@@ -44,8 +68,25 @@ class backtrack {
 			return oldValue;
 		}
 		
-		void operator()();
-		
+		void set_limits(const search_limits& l) {
+			limits = l;
+		}
+
+		search_outcome operator()();
+
+		// count-only mode: the number of solutions, where the solutions are taken to be exactly the
+		// partial solutions of length solution_length (is_solution is not called).  The candidates for
+		// the last position are counted as they come from get_candidates, never pushed, nor passed to
+		// the accumulator.
+		uint64_t count();
+
+		// how the last search ended, and the number of nodes it visited
+		search_outcome outcome() const { return last_outcome; }
+		uint64_t nodes_visited() const { return budget.nodes(); }
+
+		// the statistics policy, which holds those of the last search
+		StatsType& stats() { return statistics; }
+
 	private:
 		int									desired_solution_length;
 		std::vector<ElemType>				solution;
@@ -53,24 +94,79 @@ class backtrack {
 		Strategy<ElemType>&					strategy;		// to get candidates
 		Accumulator<ElemType>&				accumulator;	// to recieve solutions
 		bool								verbose;		// enables logging via std::cout, could be better
+		search_limits						limits;
+		search_budget						budget;
+		search_outcome						last_outcome;
+		uint64_t							num_counted;	// solutions counted by count()
+		StatsType							statistics;
+
+		template <bool Counting>
+		void search();
 
+		template <bool Counting>
+		void expand();
 };
 
 // TODO: solution_length parameter is unnecessary, desired_solution_length can be obtained from the Strategy
-template <typename ElemType>
-backtrack<ElemType>::backtrack(Strategy<ElemType>& strat, Accumulator<ElemType>& accum, int solution_length) : 
+template <typename ElemType, typename StatsType>
+backtrack<ElemType, StatsType>::backtrack(Strategy<ElemType>& strat, Accumulator<ElemType>& accum, int solution_length) : 
 	desired_solution_length(solution_length), 
 	solution(),
 	candidates(solution_length, std::stack<ElemType>()),
 	strategy(strat),
 	accumulator(accum),
-	verbose(false)
+	verbose(false),
+	limits(),
+	budget(),
+	last_outcome(search_outcome::complete),
+	num_counted(0),
+	statistics()
 {
 }
 
-template <typename ElemType>
-void backtrack<ElemType>::operator()()
+template <typename ElemType, typename StatsType>
+search_outcome backtrack<ElemType, StatsType>::operator()()
 {
+	search<false>();
+	return last_outcome;
+}
+
+template <typename ElemType, typename StatsType>
+uint64_t backtrack<ElemType, StatsType>::count()
+{
+	search<true>();
+	return num_counted;
+}
+
+// gets the candidates for the next position, in count-only mode the last position's are only counted
+template <typename ElemType, typename StatsType>
+template <bool Counting>
+void backtrack<ElemType, StatsType>::expand()
+{
+	statistics.begin_expand(solution.size());
+	strategy.get_candidates(candidates, solution);
+	statistics.end_expand(solution.size(), candidates[solution.size()].size());
+	if (Counting && int(solution.size()) == desired_solution_length - 1) {
+		std::stack<ElemType>& leaves = candidates[solution.size()];
+		num_counted += leaves.size();
+		budget.charge(leaves.size());
+		statistics.solutions(desired_solution_length, leaves.size());
+		while (!leaves.empty()) {
+			leaves.pop();
+		}
+	}
+}
+
+template <typename ElemType, typename StatsType>
+template <bool Counting>
+void backtrack<ElemType, StatsType>::search()
+{
+	budget.start(limits);
+	last_outcome = search_outcome::complete;
+	num_counted = 0;
+	statistics.start();
+	statistics.visit(0);
+
 	// either need this, or initial candidates initialized before the loop
 	bool initial_state = true;
 	
@@ -81,7 +177,7 @@ void backtrack<ElemType>::operator()()
 		// get intial candidates, could be done outside loop
 		if (initial_state) {
 			initial_state = false;
-			strategy.get_candidates(candidates, solution);
+			expand<Counting>();
 		}
 
 		// INVARIANT: pos >= 0, solution.size() == pos	
@@ -89,7 +185,9 @@ void backtrack<ElemType>::operator()()
 		while (pos >= 0 && candidates[pos].size() == 0) {
 			if (verbose) std::cout << "no candidates for position: " << pos << ", backtracking to " << pos - 1 << std::endl;
 			if (pos > 0) {
+				ElemType last = solution.back();
 				solution.pop_back();
+				strategy.on_pop(last);
 			}
 			pos -= 1;
 		}
@@ -100,25 +198,50 @@ void backtrack<ElemType>::operator()()
 		if (verbose) std::cout << "we have candidates for position: " << pos << std::endl;
 
 		// INVARIANT: pos >= 0, solution.size() == pos, candidates[pos].size() > 0
+		if (!budget.spend()) {
+			last_outcome = budget.exhausted();
+			break;
+		}
+
 		// grab the top candidate for the current position, and advance ...
 		ElemType c = candidates[pos].top();
 		if (verbose) std::cout << "selecting candidate: " << c << " for position: " << pos << std::endl;
 		candidates[pos].pop();
 		
 		solution.push_back(c);
+		strategy.on_push(c);
 		pos += 1;
+		statistics.visit(pos);
 
 		// have we built a solution?
-		if (strategy.is_solution(solution)) {
+		if (!Counting && strategy.is_solution(solution)) {
 			// we have a solution, accumulate it and get ready to find the next.
-			accumulator(solution);
+			statistics.solutions(pos, 1);
+			if (accumulator.accumulate(solution) == search_control::stop) {
+				last_outcome = search_outcome::stopped;
+				break;
+			}
 			pos -= 1;
 			solution.pop_back();
+			strategy.on_pop(c);
 		} else {
 			// not a solution yet, get candidates for the next position.
-			strategy.get_candidates(candidates, solution);
+			expand<Counting>();
+		}
+	}
+
+	// stopped early: unwind the strategy, and leave the stacks empty for the next search
+	while (!solution.empty()) {
+		ElemType last = solution.back();
+		solution.pop_back();
+		strategy.on_pop(last);
+	}
+	for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+		while (!it->empty()) {
+			it->pop();
 		}
 	}
+	statistics.finish();
 }
 
 #endif //_BACKTRACK_H_INCLUDED
\ No newline at end of file
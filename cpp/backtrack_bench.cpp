@@ -0,0 +1,189 @@
+// backtrack_bench.cpp
+
+// build: g++ -std=c++17 -O2 -march=native backtrack_bench.cpp -o backtrack_bench
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <stack>
+#include <cstdint>
+#include <cstdlib>
+
+#include "timer.h"
+#include "backtrack.h"
+#include "flat_backtrack.h"
+#include "static_backtrack.h"
+
+// all the strings of a given length over {0, .., base - 1}: the search tree is complete, every node does
+// the least work possible, so the time per node is the overhead of the engine
+class AllStrings : public Strategy<int> {
+	public:
+		AllStrings(int l, int b) : length(l), base(b)
+		{
+		}
+
+		int get_candidates(std::vector<std::stack<int>>& stacks, const std::vector<int>& partial_soln)
+		{
+			std::stack<int>& s = stacks[partial_soln.size()];
+			for (int c = 0; c < base; ++c) {
+				s.push(c);
+			}
+			return base;
+		}
+
+		bool is_solution(const std::vector<int>& soln) const
+		{
+			return soln.size() == size_t(length);
+		}
+
+	private:
+		int length;
+		int base;
+};
+
+class FlatAllStrings : public FlatStrategy<int> {
+	public:
+		FlatAllStrings(int l, int b) : length(l), base(b)
+		{
+		}
+
+		int get_candidates(candidate_buffer<int>& candidates, const std::vector<int>&)
+		{
+			for (int c = 0; c < base; ++c) {
+				candidates.push(c);
+			}
+			return base;
+		}
+
+		bool is_solution(const std::vector<int>& soln) const
+		{
+			return soln.size() == size_t(length);
+		}
+
+		size_t max_depth() const
+		{
+			return length;
+		}
+
+		size_t max_branching() const
+		{
+			return base;
+		}
+
+	private:
+		int length;
+		int base;
+};
+
+// the same, with no virtual functions, for static_backtrack
+class StaticAllStrings : public static_strategy_base<int> {
+	public:
+		StaticAllStrings(int l, int b) : length(l), base(b)
+		{
+		}
+
+		void get_candidates(candidate_buffer<int>& candidates, const std::vector<int>&)
+		{
+			for (int c = 0; c < base; ++c) {
+				candidates.push(c);
+			}
+		}
+
+		bool is_solution(const std::vector<int>& soln) const
+		{
+			return soln.size() == size_t(length);
+		}
+
+		size_t max_depth() const
+		{
+			return length;
+		}
+
+		size_t max_branching() const
+		{
+			return base;
+		}
+
+	private:
+		int length;
+		int base;
+};
+
+// sums the last element of every solution, so that the search is not optimized away
+class SumAccumulator : public Accumulator<int> {
+	public:
+		SumAccumulator() : sum(0)
+		{
+		}
+
+		void operator()(const std::vector<int>& soln)
+		{
+			sum += soln.back();
+		}
+
+		uint64_t sum;
+};
+
+struct StaticSumAccumulator {
+	uint64_t sum = 0;
+
+	void operator()(const std::vector<int>& soln)
+	{
+		sum += soln.back();
+	}
+};
+
+void report(const char* engine, double ms, uint64_t nodes, uint64_t sum)
+{
+	std::cout << "  " << std::left << std::setw(20) << engine << std::right << std::setw(10) << ms << " ms"
+			  << std::setw(10) << nodes / ms / 1000 << " Mnodes/s  (sum " << sum << ")" << std::endl;
+}
+
+void bench_all_strings(int length, int base)
+{
+	// every string of length 1..length is a node
+	uint64_t nodes = 0, level = 1;
+	for (int d = 1; d <= length; ++d) {
+		level *= base;
+		nodes += level;
+	}
+	std::cout << "strings of length " << length << " over " << base << " symbols, " << nodes << " nodes" << std::endl;
+
+	timer t;
+	{
+		AllStrings strat(length, base);
+		SumAccumulator accum;
+		backtrack<int> back(strat, accum, length);
+		t.start();
+		back();
+		report("backtrack", timer::to_milliseconds(t.stop()), nodes, accum.sum);
+	}
+	{
+		FlatAllStrings strat(length, base);
+		SumAccumulator accum;
+		flat_backtrack<int> back(strat, accum);
+		t.start();
+		back();
+		report("flat_backtrack", timer::to_milliseconds(t.stop()), nodes, accum.sum);
+	}
+	{
+		StaticAllStrings strat(length, base);
+		StaticSumAccumulator accum;
+		static_backtrack<int, StaticAllStrings, StaticSumAccumulator> back(strat, accum);
+		t.start();
+		back();
+		report("static_backtrack", timer::to_milliseconds(t.stop()), nodes, accum.sum);
+		t.start();
+		uint64_t leaves = back.count(length);
+		report("  count-only", timer::to_milliseconds(t.stop()), nodes, leaves);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int length = argc > 1 ? std::atoi(argv[1]) : 8;
+	int base = argc > 2 ? std::atoi(argv[2]) : 8;
+	bench_all_strings(length, base);
+	bench_all_strings(24, 2);
+	return 0;
+}
@@ -4,10 +4,13 @@
 #include <vector>
 #include <stack>
 #include <algorithm>
+#include <cstdint>
+#include <sstream>
 //#include <chrono>
 
 #include "timer.h"
 #include "backtrack.h"
+#include "flat_backtrack.h"
 
 std::ostream& operator<<(std::ostream& o, const std::vector<int>& a)
 {
@@ -141,6 +144,100 @@ class VectorSumIsMultN : public Strategy<int> {
 };
 
 
+// VectorSumIsMultN with the partial sum kept up to date by on_push/on_pop, instead of recomputed from
+// the partial solution at every node
+class IncrementalVectorSumIsMultN : public Strategy<int> {
+	public:
+		IncrementalVectorSumIsMultN(int l, int n) : 
+			vectorSize(l), 
+			vectorMult(n),
+			partial_sum(0)
+		{
+		}
+
+		int get_candidates(std::vector<std::stack<int>>& stacks, const std::vector<int>& partial_soln)
+		{
+			static const int all_candidates[] = {1,2,3,4,5,6,7,8,9};
+			int pos = partial_soln.size();
+			int num_left = stacks.size() - partial_soln.size();
+			for (int candidate : all_candidates) {
+				if (num_left > 1 || (partial_sum + candidate) % vectorMult == 0) {		// last position, be careful ...
+					stacks[pos].push(candidate);
+				}
+			}
+			return stacks[pos].size();
+		}
+
+		bool is_solution(const std::vector<int>& solution) const
+		{
+			return solution.size() == size_t(vectorSize);
+		}
+
+		void on_push(const int& elem)
+		{
+			partial_sum = (partial_sum + elem) % vectorMult;
+		}
+
+		void on_pop(const int& elem)
+		{
+			partial_sum = (partial_sum - elem % vectorMult + vectorMult) % vectorMult;
+		}
+
+	private:
+		int vectorSize;
+		int	vectorMult;
+		int partial_sum;		// of the partial solution, mod vectorMult
+};
+
+// VectorSumIsMultN for flat_backtrack: the same candidates, in the same order, pushed into the
+// candidate buffer
+class FlatVectorSumIsMultN : public FlatStrategy<int> {
+	public:
+		FlatVectorSumIsMultN(int l, int n) : 
+			vectorSize(l), 
+			vectorMult(n)
+		{
+		}
+
+		int get_candidates(candidate_buffer<int>& candidates, const std::vector<int>& partial_soln)
+		{
+			static const int all_candidates[] = {1,2,3,4,5,6,7,8,9};
+			int partial_sum = 0;
+			for (std::vector<int>::const_iterator it = partial_soln.begin(); it != partial_soln.end(); ++it) {
+				partial_sum += *it;
+				partial_sum = partial_sum % vectorMult;
+			}
+			int num_left = vectorSize - partial_soln.size();
+			int num_candidates = 0;
+			for (int candidate : all_candidates) {
+				if (num_left > 1 || (partial_sum + candidate) % vectorMult == 0) {		// last position, be careful ...
+					candidates.push(candidate);
+					++num_candidates;
+				}
+			}
+			return num_candidates;
+		}
+
+		bool is_solution(const std::vector<int>& solution) const
+		{
+			return solution.size() == size_t(vectorSize);
+		}
+
+		size_t max_depth() const
+		{
+			return vectorSize;
+		}
+
+		size_t max_branching() const
+		{
+			return 9;
+		}
+
+	private:
+		int vectorSize;
+		int	vectorMult;
+};
+
 class OutputAccumulator : public Accumulator<int> {
 	public:
 		OutputAccumulator(std::ostream& o) : 
@@ -162,6 +259,186 @@ class OutputAccumulator : public Accumulator<int> {
 	
 };
 
+// counts the solutions, and folds them into a checksum that depends on their order
+class ChecksumAccumulator : public Accumulator<int> {
+	public:
+		ChecksumAccumulator() : num_solutions(0), checksum(0)
+		{
+		}
+
+		void operator()(const std::vector<int>& soln)
+		{
+			++num_solutions;
+			for (std::vector<int>::const_iterator it = soln.begin(); it != soln.end(); ++it) {
+				checksum = checksum * 31 + *it;
+			}
+		}
+
+		uint64_t num_solutions;
+		uint64_t checksum;
+};
+
+// stops the search once it has k solutions
+class FirstKAccumulator : public ChecksumAccumulator {
+	public:
+		FirstKAccumulator(uint64_t k) : limit(k)
+		{
+		}
+
+		search_control accumulate(const std::vector<int>& soln)
+		{
+			(*this)(soln);
+			return num_solutions < limit ? search_control::proceed : search_control::stop;
+		}
+
+	private:
+		uint64_t limit;
+};
+
+// count-only, first k and budgeted searches, on both engines; each leaves the strategy as it found it,
+// which the last full search checks
+int check_modes(int length, int mult)
+{
+	int failures = 0;
+	ChecksumAccumulator all;
+	IncrementalVectorSumIsMultN strat(length, mult);
+	FlatVectorSumIsMultN flat_strat(length, mult);
+	backtrack<int> back(strat, all, length);
+	failures += back() != search_outcome::complete;
+
+	backtrack<int> counting(strat, all, length);
+	failures += counting.count() != all.num_solutions;
+	flat_backtrack<int> flat_counting(flat_strat, all);
+	failures += flat_counting.count(length) != all.num_solutions;
+
+	for (uint64_t k : {uint64_t(1), uint64_t(10), all.num_solutions, all.num_solutions + 1}) {
+		FirstKAccumulator first(k), flat_first(k);
+		backtrack<int> back_first(strat, first, length);
+		search_outcome outcome = back_first();
+		failures += first.num_solutions != std::min(k, all.num_solutions);
+		failures += outcome != (k <= all.num_solutions ? search_outcome::stopped : search_outcome::complete);
+		flat_backtrack<int> flat_back_first(flat_strat, flat_first);
+		failures += flat_back_first() != outcome;
+		failures += flat_first.num_solutions != first.num_solutions || flat_first.checksum != first.checksum;
+	}
+
+	search_limits nodes;
+	nodes.max_nodes = 1000;
+	ChecksumAccumulator some;
+	backtrack<int> back_nodes(strat, some, length);
+	back_nodes.set_limits(nodes);
+	failures += back_nodes() != search_outcome::node_limit || back_nodes.nodes_visited() != 1000;
+	flat_backtrack<int> flat_nodes(flat_strat, some);
+	flat_nodes.set_limits(nodes);
+	failures += flat_nodes() != search_outcome::node_limit || flat_nodes.nodes_visited() != 1000;
+	nodes.max_nodes = back.nodes_visited();
+	back_nodes.set_limits(nodes);
+	failures += back_nodes() != search_outcome::complete;
+
+	// no time at all: the search ends at the first look at the clock
+	search_limits time;
+	time.max_time = timer::duration(0);
+	backtrack<int> back_time(strat, some, length);
+	back_time.set_limits(time);
+	failures += back_time() != search_outcome::time_limit || back_time.nodes_visited() != search_budget::time_check_interval;
+	back_time.count();
+	failures += back_time.outcome() != search_outcome::time_limit;
+
+	ChecksumAccumulator again;
+	backtrack<int> back_again(strat, again, length);
+	back_again();
+	failures += again.num_solutions != all.num_solutions || again.checksum != all.checksum;
+	return failures;
+}
+
+// per depth statistics of both engines, full and count-only: VectorSumIsMultN has every candidate for
+// the first length - 1 positions, so depth d < length has 9^d nodes and no dead end
+int check_stats(int length, int mult)
+{
+	int failures = 0;
+	ChecksumAccumulator all, flat_all;
+	VectorSumIsMultN strat(length, mult);
+	FlatVectorSumIsMultN flat_strat(length, mult);
+	backtrack<int, depth_search_stats> back(strat, all, length);
+	back();
+	static_backtrack<int, FlatStrategy<int>, Accumulator<int>, depth_search_stats> flat_back(flat_strat, flat_all);
+	flat_back();
+
+	const search_stats& stats = back.stats().get();
+	const search_stats& flat_stats = flat_back.stats().get();
+	failures += stats.depths.size() != size_t(length) + 1 || flat_stats.depths.size() != stats.depths.size();
+	uint64_t nodes = 1;
+	for (size_t d = 0; d < stats.depths.size() && d < flat_stats.depths.size(); ++d) {
+		const search_depth_stats& s = stats.depths[d];
+		const search_depth_stats& f = flat_stats.depths[d];
+		failures += s.nodes != f.nodes || s.candidates != f.candidates || s.dead_ends != f.dead_ends || s.solutions != f.solutions;
+		if (d < size_t(length)) {
+			failures += s.nodes != nodes || s.dead_ends != 0 || s.solutions != 0;
+			failures += d + 1 < stats.depths.size() && s.candidates != stats.depths[d + 1].nodes;
+			nodes *= 9;
+		}
+	}
+	failures += stats.total().solutions != all.num_solutions || stats.depths.back().solutions != all.num_solutions;
+
+	back.count();
+	failures += back.stats().get().depths.size() != size_t(length) + 1 || back.stats().get().total().solutions != all.num_solutions;
+
+	std::ostringstream csv, json;
+	write_csv(csv, stats);
+	write_json(json, stats);
+	std::string lines = csv.str(), object = json.str();
+	failures += std::count(lines.begin(), lines.end(), '\n') != length + 2;
+	failures += object.find("{\"elapsed_ns\": ") != 0 || object.find("\"depth\": " + std::to_string(length)) == std::string::npos;
+	return failures;
+}
+
+// backtrack vs flat_backtrack on the same problem: same solutions in the same order, and the time per
+// solution of each engine
+void compare_engines(int length, int mult)
+{
+	ChecksumAccumulator stacked, flat;
+	VectorSumIsMultN strat(length, mult);
+	FlatVectorSumIsMultN flat_strat(length, mult);
+
+	timer t;
+	t.start();
+	backtrack<int> back(strat, stacked, length);
+	back();
+	double stacked_ms = timer::to_milliseconds(t.stop());
+
+	t.start();
+	flat_backtrack<int> flat_back(flat_strat, flat);
+	flat_back();
+	double flat_ms = timer::to_milliseconds(t.stop());
+
+	std::cout << "VectorSumIsMultN(" << length << ", " << mult << "): " << stacked.num_solutions << " solutions" << std::endl;
+	std::cout << "  backtrack      : " << stacked_ms << " ms" << std::endl;
+	std::cout << "  flat_backtrack : " << flat_ms << " ms"
+			  << (flat.num_solutions == stacked.num_solutions && flat.checksum == stacked.checksum ? "" : "  MISMATCH") << std::endl;
+
+	ChecksumAccumulator incremental;
+	IncrementalVectorSumIsMultN incremental_strat(length, mult);
+	t.start();
+	backtrack<int> incremental_back(incremental_strat, incremental, length);
+	incremental_back();
+	double incremental_ms = timer::to_milliseconds(t.stop());
+	std::cout << "  backtrack, on_push/on_pop partial sum : " << incremental_ms << " ms"
+			  << (incremental.num_solutions == stacked.num_solutions && incremental.checksum == stacked.checksum ? "" : "  MISMATCH") << std::endl;
+
+	t.start();
+	backtrack<int> counting_back(incremental_strat, incremental, length);
+	uint64_t counted = counting_back.count();
+	double counting_ms = timer::to_milliseconds(t.stop());
+	std::cout << "  backtrack, count-only : " << counting_ms << " ms"
+			  << (counted == stacked.num_solutions ? "" : "  MISMATCH") << std::endl;
+
+	ChecksumAccumulator instrumented;
+	backtrack<int, depth_search_stats> stats_back(strat, instrumented, length);
+	stats_back();
+	std::cout << "  per depth statistics, " << timer::to_milliseconds(stats_back.stats().get().elapsed) << " ms:" << std::endl;
+	write_csv(std::cout, stats_back.stats().get());
+}
+
 int main()
 {
 	timer t;
@@ -187,4 +464,11 @@ int main()
 	std::cout << "elapsed time = " << timer::to_microseconds(d) << " us" << std::endl;
 	std::cout << "elapsed time = " << timer::to_milliseconds(d) << " ms" << std::endl;
 	std::cout << "elapsed time = " << timer::to_microseconds(d)/output.solution_count() << " us/solution" << std::endl;
+
+	compare_engines(4, 5);
+	compare_engines(7, 5);
+
+	int failures = check_modes(4, 5) + check_modes(6, 3) + check_stats(4, 5) + check_stats(6, 3);
+	std::cout << "search modes: " << failures << " failures" << std::endl;
+	return failures == 0 ? 0 : 1;
 }
@@ -0,0 +1,524 @@
+// basic_powerset.h
+
+/***
+basic_powerset<Order, Storage> is the powerset enumeration of powerset.h with the order and the
+representation of the subset chosen at compile time, so nothing on the stepping path is virtual and
+next() inlines into the caller's loop.
+
+Storage policies, the subset of {0, ..., N-1}:
+
+	word_storage<W>		: packed bits in words of type W (default uint64_t), element i is bit i
+	bitvec_storage		: a vector<bool>, as held by powerset
+
+Order policies, with the same enumeration orders (and ranks) as their powerset.h counterparts:
+
+	binary_order		: x + 1
+	graycode_order		: flip bit ctz(r) of the subset of rank r-1
+	lexicographic_order	: preorder walk of the subset tree, extend by the next element or backtrack
+
+An order steps the storage through a handful of primitive operations (test, set, reset, flip,
+highest), which the storage implements inline.  Three ways to enumerate, all visiting {} first:
+
+	for (basic_powerset<graycode_order> ps(N); !ps.done(); ps.next()) { ... ps.subset() ... }
+	for (auto& ps : basic_powerset<graycode_order>(N)) { ... ps.subset() ... }
+	basic_powerset<graycode_order>(N).for_each([&](const word_storage<>& subset) { ... });
+
+for_each() is the internal iteration fast path: the done() test folds into the loop condition.  With
+C++20, basic_powerset_view<Order, Storage>(N) is a std::ranges view of the enumeration, which composes
+with the standard range adaptors.
+
+rank()/seek(r) are positions in the order, as in powerset.h, and need N < 64.  count() is 2^N.
+***/
+
+#ifndef _BASIC_POWERSET_H_INCLUDED_
+#define _BASIC_POWERSET_H_INCLUDED_
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <iterator>
+#include <type_traits>
+
+#include "bitops.h"
+#include "powerset.h"
+
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
+
+template <typename WordType = uint64_t>
+class word_storage {
+
+    static_assert(std::is_unsigned<WordType>::value && !std::is_same<WordType, bool>::value, "WordType must be an unsigned integer type.");
+
+    public:
+        static const size_t WORD_BITS = 8 * sizeof(WordType);
+
+        explicit word_storage(size_t N) : n(N), words((N + WORD_BITS - 1) / WORD_BITS + (N == 0), 0), popcount(0)
+        {
+        }
+
+        size_t size() const
+        {
+            return n;
+        }
+
+        // the number of elements in the subset
+        size_t count() const
+        {
+            return popcount;
+        }
+
+        bool test(size_t i) const
+        {
+            return (words[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+        }
+
+        void set(size_t i)
+        {
+            words[i / WORD_BITS] |= WordType(1) << (i % WORD_BITS);
+            ++popcount;
+        }
+
+        void reset(size_t i)
+        {
+            words[i / WORD_BITS] &= ~(WordType(1) << (i % WORD_BITS));
+            --popcount;
+        }
+
+        void flip(size_t i)
+        {
+            WordType mask = WordType(1) << (i % WORD_BITS);
+            words[i / WORD_BITS] ^= mask;
+            popcount += (words[i / WORD_BITS] & mask) ? 1 : -1;
+        }
+
+        // the largest element, or -1 for {}
+        int highest() const
+        {
+            for (size_t i = words.size(); i-- > 0; ) {
+                if (words[i] != 0) {
+                    return int(i * WORD_BITS + 63 - bitops::clz(uint64_t(words[i])));
+                }
+            }
+            return -1;
+        }
+
+        void clear()
+        {
+            std::fill(words.begin(), words.end(), WordType(0));
+            popcount = 0;
+        }
+
+        uint64_t to_uint64() const
+        {
+            assert(n < 64);
+            uint64_t x = 0;
+            for (size_t i = 0; i < words.size() && i * WORD_BITS < 64; ++i) {
+                x |= uint64_t(words[i]) << (i * WORD_BITS);
+            }
+            return x;
+        }
+
+        void assign_uint64(uint64_t x)
+        {
+            assert(n < 64);
+            for (size_t i = 0; i < words.size(); ++i) {
+                words[i] = (i * WORD_BITS < 64 ? WordType(x >> (i * WORD_BITS)) : 0);
+            }
+            popcount = bitops::popcount(x);
+        }
+
+        const std::vector<WordType>& get_words() const
+        {
+            return words;
+        }
+
+        std::vector<bool> to_bitvec() const
+        {
+            std::vector<bool> bitvec(n, false);
+            for (size_t i = 0; i < n; ++i) {
+                bitvec[i] = test(i);
+            }
+            return bitvec;
+        }
+
+        std::vector<int> to_listvec() const
+        {
+            std::vector<int> listvec;
+            for (size_t i = 0; i < words.size(); ++i) {
+                for (WordType w = words[i]; w != 0; w &= w - 1) {
+                    listvec.push_back(int(i * WORD_BITS + bitops::ctz(uint64_t(w))));
+                }
+            }
+            return listvec;
+        }
+
+    private:
+        size_t n;
+        std::vector<WordType> words;
+        size_t popcount;
+};
+
+class bitvec_storage {
+    public:
+        explicit bitvec_storage(size_t N) : bitvec(N, false), popcount(0)
+        {
+        }
+
+        size_t size() const
+        {
+            return bitvec.size();
+        }
+
+        size_t count() const
+        {
+            return popcount;
+        }
+
+        bool test(size_t i) const
+        {
+            return bitvec[i];
+        }
+
+        void set(size_t i)
+        {
+            bitvec[i] = true;
+            ++popcount;
+        }
+
+        void reset(size_t i)
+        {
+            bitvec[i] = false;
+            --popcount;
+        }
+
+        void flip(size_t i)
+        {
+            bitvec[i] = !bitvec[i];
+            popcount += bitvec[i] ? 1 : -1;
+        }
+
+        int highest() const
+        {
+            for (size_t i = bitvec.size(); i-- > 0; ) {
+                if (bitvec[i]) {
+                    return int(i);
+                }
+            }
+            return -1;
+        }
+
+        void clear()
+        {
+            bitvec.assign(bitvec.size(), false);
+            popcount = 0;
+        }
+
+        uint64_t to_uint64() const
+        {
+            return powerset_binary::rank(bitvec);
+        }
+
+        void assign_uint64(uint64_t x)
+        {
+            bitvec = powerset_binary::unrank(x, bitvec.size());
+            popcount = bitops::popcount(x);
+        }
+
+        const std::vector<bool>& get_bitvec() const
+        {
+            return bitvec;
+        }
+
+        std::vector<bool> to_bitvec() const
+        {
+            return bitvec;
+        }
+
+        std::vector<int> to_listvec() const
+        {
+            return set_adapter::to_listvec(bitvec);
+        }
+
+    private:
+        std::vector<bool> bitvec;
+        size_t popcount;
+};
+
+// Each order policy steps a storage with next(s), which returns false, leaving the storage as it
+// is, when s is the last subset of the order.
+struct binary_order {
+    template <typename Storage>
+    bool next(Storage& s)
+    {
+        if (s.count() == s.size()) {
+            return false;
+        }
+        size_t i = 0;
+        while (s.test(i)) {
+            s.reset(i++);
+        }
+        s.set(i);
+        return true;
+    }
+
+    template <typename Storage>
+    uint64_t rank(const Storage& s) const
+    {
+        return s.to_uint64();
+    }
+
+    template <typename Storage>
+    void seek(Storage& s, uint64_t r)
+    {
+        s.assign_uint64(r);
+    }
+};
+
+struct graycode_order {
+    uint64_t r = 0;
+
+    template <typename Storage>
+    bool next(Storage& s)
+    {
+        if (s.size() == 0 || (s.count() == 1 && s.test(s.size() - 1))) {
+            return false;
+        }
+        s.flip(bitops::ctz(++r));
+        return true;
+    }
+
+    template <typename Storage>
+    uint64_t rank(const Storage&) const
+    {
+        return r;
+    }
+
+    template <typename Storage>
+    void seek(Storage& s, uint64_t rank)
+    {
+        r = rank;
+        s.assign_uint64(r ^ (r >> 1));
+    }
+};
+
+struct lexicographic_order {
+    template <typename Storage>
+    bool next(Storage& s)
+    {
+        int last = int(s.size()) - 1;
+        int h = s.highest();
+        if (h < last) {             // extend by the next element, {} is extended by 0
+            s.set(h + 1);
+            return true;
+        }
+        if (last < 0) {
+            return false;
+        }
+        s.reset(h);                 // N-1 has no children: backtrack to the next sibling of the parent
+        h = s.highest();
+        if (h < 0) {                // that was {N-1}, the last subset
+            s.set(last);
+            return false;
+        }
+        s.reset(h);
+        s.set(h + 1);
+        return true;
+    }
+
+    template <typename Storage>
+    uint64_t rank(const Storage& s) const
+    {
+        return powerset_lexicographic::rank(s.to_listvec(), s.size());
+    }
+
+    template <typename Storage>
+    void seek(Storage& s, uint64_t r)
+    {
+        std::vector<int> listvec = powerset_lexicographic::unrank_listvec(r, s.size());
+        s.clear();
+        for (auto it = listvec.begin(); it != listvec.end(); ++it) {
+            s.set(*it);
+        }
+    }
+};
+
+template <typename Order, typename Storage = word_storage<>>
+class basic_powerset {
+    public:
+        typedef Order order_type;
+        typedef Storage storage_type;
+
+        class iterator {
+            public:
+                typedef std::input_iterator_tag iterator_category;
+                typedef basic_powerset value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const basic_powerset* pointer;
+                typedef const basic_powerset& reference;
+
+                iterator() : ref_set(nullptr)
+                {
+                }
+
+                explicit iterator(basic_powerset* p) : ref_set(p)
+                {
+                }
+
+                reference operator*() const
+                {
+                    return *ref_set;
+                }
+
+                pointer operator->() const
+                {
+                    return ref_set;
+                }
+
+                iterator& operator++()
+                {
+                    ref_set->next();
+                    return *this;
+                }
+
+                void operator++(int)
+                {
+                    ref_set->next();
+                }
+
+                // an iterator is at the end when its enumeration is done, the end() iterator always is
+                bool operator==(const iterator& other) const
+                {
+                    return at_end() == other.at_end();
+                }
+
+                bool operator!=(const iterator& other) const
+                {
+                    return !(*this == other);
+                }
+
+            private:
+                basic_powerset* ref_set;
+
+                bool at_end() const
+                {
+                    return ref_set == nullptr || ref_set->done();
+                }
+        };
+
+        explicit basic_powerset(size_t N) : storage(N), order(), _done(false)
+        {
+        }
+
+        iterator begin()
+        {
+            return iterator(this);
+        }
+
+        iterator end()
+        {
+            return iterator();
+        }
+
+        bool done() const
+        {
+            return _done;
+        }
+
+        void next()
+        {
+            if (!order.next(storage)) {     // one past the end
+                _done = true;
+            }
+        }
+
+        // calls visit(subset()) for every remaining subset, then leaves the enumeration done()
+        template <typename Visitor>
+        void for_each(Visitor visit)
+        {
+            if (_done) {
+                return;
+            }
+            do {
+                visit(static_cast<const Storage&>(storage));
+            } while (order.next(storage));
+            _done = true;
+        }
+
+        const Storage& subset() const
+        {
+            return storage;
+        }
+
+        bool contains(size_t i) const
+        {
+            return storage.test(i);
+        }
+
+        size_t size() const
+        {
+            return storage.size();
+        }
+
+        // the number of elements in the current subset
+        size_t index() const
+        {
+            return storage.count();
+        }
+
+        uint64_t count() const
+        {
+            assert(storage.size() < 64);
+            return uint64_t(1) << storage.size();
+        }
+
+        uint64_t rank() const
+        {
+            return order.rank(storage);
+        }
+
+        void seek(uint64_t r)
+        {
+            assert(r < count());
+            order.seek(storage, r);
+            _done = false;
+        }
+
+    private:
+        Storage storage;
+        Order order;
+        bool _done;
+};
+
+#if __cplusplus >= 202002L
+// An owning view of a basic_powerset enumeration, single pass.  The enumeration lives on the heap so
+// that moving the view is O(1), as views require.
+template <typename Order, typename Storage = word_storage<>>
+class basic_powerset_view : public std::ranges::view_interface<basic_powerset_view<Order, Storage>> {
+    public:
+        basic_powerset_view() = default;
+
+        explicit basic_powerset_view(size_t N) : ps(std::make_unique<basic_powerset<Order, Storage>>(N))
+        {
+        }
+
+        typename basic_powerset<Order, Storage>::iterator begin()
+        {
+            return ps->begin();
+        }
+
+        typename basic_powerset<Order, Storage>::iterator end()
+        {
+            return ps->end();
+        }
+
+    private:
+        std::unique_ptr<basic_powerset<Order, Storage>> ps;
+};
+#endif
+
+#endif //_BASIC_POWERSET_H_INCLUDED_
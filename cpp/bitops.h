@@ -0,0 +1,190 @@
+// bitops.h
+
+/***
+Word-level helpers for packed bitmaps of 64-bit words.  The scalar helpers (ctz, clz, popcount)
+map to a single instruction on any recent compiler/target.  The bulk kernels (and/or/andnot over
+arrays of words) use AVX-512 or AVX2 when the translation unit is compiled with support for them
+(eg: -mavx2, -mavx512f, or -march=native), and fall back to a plain word-at-a-time loop otherwise.
+***/
+
+#ifndef _BITOPS_H_INCLUDED_
+#define _BITOPS_H_INCLUDED_
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace bitops {
+
+	const size_t WORD_BITS = 64;
+
+	inline size_t words_for(uint64_t bits)
+	{
+		return size_t((bits + WORD_BITS - 1) / WORD_BITS);
+	}
+
+	inline uint64_t bit(uint64_t i)
+	{
+		return uint64_t(1) << (i % WORD_BITS);
+	}
+
+	// count trailing zeros, w must be non-zero
+	inline int ctz(uint64_t w)
+	{
+#if defined(_MSC_VER)
+		unsigned long idx;
+		_BitScanForward64(&idx, w);
+		return int(idx);
+#else
+		return __builtin_ctzll(w);
+#endif
+	}
+
+	// count leading zeros, w must be non-zero
+	inline int clz(uint64_t w)
+	{
+#if defined(_MSC_VER)
+		unsigned long idx;
+		_BitScanReverse64(&idx, w);
+		return 63 - int(idx);
+#else
+		return __builtin_clzll(w);
+#endif
+	}
+
+	inline int popcount(uint64_t w)
+	{
+#if defined(_MSC_VER)
+		return int(__popcnt64(w));
+#else
+		return __builtin_popcountll(w);
+#endif
+	}
+
+	// dst[i] &= src[i], for i in [0,n)
+	inline void and_assign(uint64_t* dst, const uint64_t* src, size_t n)
+	{
+		size_t i = 0;
+#if defined(__AVX512F__)
+		for (; i + 8 <= n; i += 8) {
+			__m512i a = _mm512_loadu_si512((const void*)(dst + i));
+			__m512i b = _mm512_loadu_si512((const void*)(src + i));
+			_mm512_storeu_si512((void*)(dst + i), _mm512_and_si512(a, b));
+		}
+#elif defined(__AVX2__)
+		for (; i + 4 <= n; i += 4) {
+			__m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+			__m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+			_mm256_storeu_si256((__m256i*)(dst + i), _mm256_and_si256(a, b));
+		}
+#endif
+		for (; i < n; ++i) {
+			dst[i] &= src[i];
+		}
+	}
+
+	// dst[i] |= src[i], for i in [0,n)
+	inline void or_assign(uint64_t* dst, const uint64_t* src, size_t n)
+	{
+		size_t i = 0;
+#if defined(__AVX512F__)
+		for (; i + 8 <= n; i += 8) {
+			__m512i a = _mm512_loadu_si512((const void*)(dst + i));
+			__m512i b = _mm512_loadu_si512((const void*)(src + i));
+			_mm512_storeu_si512((void*)(dst + i), _mm512_or_si512(a, b));
+		}
+#elif defined(__AVX2__)
+		for (; i + 4 <= n; i += 4) {
+			__m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+			__m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+			_mm256_storeu_si256((__m256i*)(dst + i), _mm256_or_si256(a, b));
+		}
+#endif
+		for (; i < n; ++i) {
+			dst[i] |= src[i];
+		}
+	}
+
+	// dst[i] &= ~src[i], for i in [0,n)
+	inline void andnot_assign(uint64_t* dst, const uint64_t* src, size_t n)
+	{
+		size_t i = 0;
+#if defined(__AVX512F__)
+		for (; i + 8 <= n; i += 8) {
+			__m512i a = _mm512_loadu_si512((const void*)(dst + i));
+			__m512i b = _mm512_loadu_si512((const void*)(src + i));
+			_mm512_storeu_si512((void*)(dst + i), _mm512_andnot_si512(b, a));
+		}
+#elif defined(__AVX2__)
+		for (; i + 4 <= n; i += 4) {
+			__m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+			__m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+			_mm256_storeu_si256((__m256i*)(dst + i), _mm256_andnot_si256(b, a));
+		}
+#endif
+		for (; i < n; ++i) {
+			dst[i] &= ~src[i];
+		}
+	}
+
+	// returns popcount(a[i] & b[i]) summed over [0,n)
+	inline uint64_t popcount_and(const uint64_t* a, const uint64_t* b, size_t n)
+	{
+		uint64_t count = 0;
+		for (size_t i = 0; i < n; ++i) {
+			count += popcount(a[i] & b[i]);
+		}
+		return count;
+	}
+
+	// returns true if (a[i] & b[i]) != 0 for some i in [0,n)
+	inline bool any_and(const uint64_t* a, const uint64_t* b, size_t n)
+	{
+		size_t i = 0;
+#if defined(__AVX512F__)
+		for (; i + 8 <= n; i += 8) {
+			__m512i x = _mm512_loadu_si512((const void*)(a + i));
+			__m512i y = _mm512_loadu_si512((const void*)(b + i));
+			if (_mm512_test_epi64_mask(x, y) != 0) {
+				return true;
+			}
+		}
+#elif defined(__AVX2__)
+		for (; i + 4 <= n; i += 4) {
+			__m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+			__m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+			if (!_mm256_testz_si256(x, y)) {
+				return true;
+			}
+		}
+#endif
+		for (; i < n; ++i) {
+			if (a[i] & b[i]) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// calls f(index) for every set bit in the n words starting at w, in increasing order
+	template <typename Function>
+	inline void for_each_bit(const uint64_t* w, size_t n, Function f)
+	{
+		for (size_t i = 0; i < n; ++i) {
+			uint64_t word = w[i];
+			while (word != 0) {
+				f(uint64_t(i * WORD_BITS + ctz(word)));
+				word &= word - 1;
+			}
+		}
+	}
+}
+
+#endif //_BITOPS_H_INCLUDED_
@@ -0,0 +1,151 @@
+// concurrent_fast_set.h
+
+/***
+concurrent_fast_set<T>(N) is an insert-only fast_set<T>(N) that may be shared by many threads, eg: a
+"visited" or "claimed" set in a parallel search.  Membership is an array of atomic 64-bit words, one
+bit per element of [0,N), and the unordered element list is an array of N atomic slots with an atomic
+append index:
+
+	insert(e)	: fetch_or the bit of e.  The one thread that flips it from 0 to 1 owns e: it reserves
+				  a slot with fetch_add on the append index, and publishes e into that slot.
+	contains(e)	: a single atomic load of the word holding e.
+
+Both are lock-free and O(1).  Exactly one insert(e) returns true for each element e, no matter how
+many threads race on it, so insert doubles as an atomic claim.
+
+Consistency, while inserts are in flight:
+	- contains(e) is true as soon as the inserting thread has flipped the bit (before insert returns).
+	- size() counts reserved slots, which can run ahead of the published ones by the number of
+	  inserts in flight, so an element counted by size() may not be visible in the list for a moment.
+	- uniform_select(p) picks slot floor(p * size()), and if that slot is not yet published it walks
+	  back to the nearest published slot (and returns NO_VALUE only if none is published yet).  So an
+	  element just before a run of unpublished slots also takes their share of the probability mass.
+	  Once the inserters are quiescent the selection is exactly uniform.
+	- (*this)[i] and cbegin()/cend() style enumeration are only meaningful when quiescent.
+
+There is no remove(): the swap-with-last trick of fast_set cannot be made lock-free without giving up
+O(1) contains.  clear() is O(n) and must not run concurrently with anything else.
+***/
+
+#ifndef _CONCURRENT_FAST_SET_INCLUDED_
+#define _CONCURRENT_FAST_SET_INCLUDED_
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cassert>
+#include <type_traits>
+
+#include "bitops.h"
+
+template <typename UnsignedIntType>
+class concurrent_fast_set {
+
+	static_assert(std::is_unsigned<UnsignedIntType>::value, "Template parameter must be unsigned.");
+	static_assert(!std::is_same<UnsignedIntType, bool>::value, "Template parameter must not be bool.");
+
+	public:
+		typedef UnsignedIntType element_type;
+
+		static const UnsignedIntType NO_VALUE = UnsignedIntType(-1);
+
+		concurrent_fast_set(UnsignedIntType capacity) :
+			_capacity(capacity),
+			_num_words(bitops::words_for(capacity)),
+			_num_elements(0),
+			_bits(new std::atomic<uint64_t>[_num_words]),
+			_elements(new std::atomic<UnsignedIntType>[_capacity])
+		{
+			assert(_capacity < NO_VALUE);
+
+			for (uint64_t i = 0; i < _num_words; ++i) {
+				_bits[i].store(0, std::memory_order_relaxed);
+			}
+			for (uint64_t i = 0; i < _capacity; ++i) {
+				_elements[i].store(NO_VALUE, std::memory_order_relaxed);
+			}
+		}
+
+		concurrent_fast_set(const concurrent_fast_set&) = delete;
+		concurrent_fast_set& operator=(const concurrent_fast_set&) = delete;
+
+		// returns true iff this call added element, exactly one concurrent caller wins
+		bool insert(UnsignedIntType element)
+		{
+			assert(element < _capacity);
+
+			uint64_t mask = bitops::bit(element);
+			uint64_t old = _bits[element / bitops::WORD_BITS].fetch_or(mask, std::memory_order_acq_rel);
+			if (old & mask) {
+				return false;
+			}
+			uint64_t slot = _num_elements.fetch_add(1, std::memory_order_relaxed);
+			_elements[slot].store(element, std::memory_order_release);
+			return true;
+		}
+
+		bool contains(UnsignedIntType element) const
+		{
+			assert(element < _capacity);
+
+			return (_bits[element / bitops::WORD_BITS].load(std::memory_order_acquire) & bitops::bit(element)) != 0;
+		}
+
+		bool is_empty() const
+		{
+			return size() == 0;
+		}
+
+		uint64_t size() const
+		{
+			return _num_elements.load(std::memory_order_acquire);
+		}
+
+		uint64_t capacity() const
+		{
+			return _capacity;
+		}
+
+		// the element in slot i, or NO_VALUE if its insert has not been published yet
+		UnsignedIntType operator[](uint64_t i) const
+		{
+			assert(i < _capacity);
+
+			return _elements[i].load(std::memory_order_acquire);
+		}
+
+		UnsignedIntType uniform_select(double p) const
+		{
+			assert(p >= 0.0 && p < 1.0);
+
+			uint64_t index = uint64_t(p * size());
+			for (uint64_t i = index + 1; i-- > 0; ) {
+				UnsignedIntType e = _elements[i].load(std::memory_order_acquire);
+				if (e != NO_VALUE) {
+					return e;
+				}
+			}
+			return NO_VALUE;
+		}
+
+		// not thread safe, no other operation may run concurrently
+		void clear()
+		{
+			uint64_t n = _num_elements.load(std::memory_order_relaxed);
+			for (uint64_t i = 0; i < n; ++i) {
+				UnsignedIntType e = _elements[i].load(std::memory_order_relaxed);
+				_bits[e / bitops::WORD_BITS].store(0, std::memory_order_relaxed);
+				_elements[i].store(NO_VALUE, std::memory_order_relaxed);
+			}
+			_num_elements.store(0, std::memory_order_release);
+		}
+
+	private:
+		uint64_t								_capacity;
+		uint64_t								_num_words;
+		std::atomic<uint64_t>					_num_elements;		// reserved slots
+		std::unique_ptr<std::atomic<uint64_t>[]>		_bits;
+		std::unique_ptr<std::atomic<UnsignedIntType>[]>	_elements;
+};
+
+#endif //_CONCURRENT_FAST_SET_INCLUDED_
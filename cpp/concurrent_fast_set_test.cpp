@@ -0,0 +1,131 @@
+// concurrent_fast_set_test.cpp
+
+// build: g++ -std=c++14 -O2 concurrent_fast_set_test.cpp -o concurrent_fast_set_test -pthread
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "concurrent_fast_set.h"
+#include "superkiss64.h"
+#include "timer.h"
+
+// Every thread inserts every element of the universe, in its own random order, while a reader
+// thread checks that contains() never goes from true back to false and that uniform_select()
+// only returns inserted elements.  Afterwards each element must have been won by exactly one
+// thread, and the element list must be a permutation of the universe.
+int stress_test(int num_threads, uint32_t N)
+{
+	concurrent_fast_set<uint32_t> set(N);
+	std::vector<std::vector<uint32_t>> orders(num_threads, std::vector<uint32_t>(N));
+	for (int t = 0; t < num_threads; ++t) {
+		for (uint32_t e = 0; e < N; ++e) {
+			orders[t][e] = e;
+		}
+		std::shuffle(orders[t].begin(), orders[t].end(), std::mt19937(t));
+	}
+
+	std::vector<uint64_t> wins(num_threads, 0);
+	std::atomic<bool> writers_done(false);
+	std::atomic<int> reader_errors(0);
+
+	std::thread reader([&]() {
+		superkiss64 rng;
+		std::vector<bool> seen(N, false);
+		while (!writers_done.load()) {
+			uint32_t e = uint32_t(rng.rand() % N);
+			bool present = set.contains(e);
+			if (seen[e] && !present) {
+				++reader_errors;
+			}
+			seen[e] = seen[e] || present;
+			uint32_t s = set.uniform_select(rng.rand01());
+			if (s != set.NO_VALUE && !set.contains(s)) {
+				++reader_errors;
+			}
+		}
+	});
+
+	std::vector<std::thread> writers;
+	for (int t = 0; t < num_threads; ++t) {
+		writers.push_back(std::thread([&, t]() {
+			for (uint32_t e : orders[t]) {
+				wins[t] += set.insert(e);
+			}
+		}));
+	}
+	for (auto& w : writers) {
+		w.join();
+	}
+	writers_done = true;
+	reader.join();
+
+	int failures = reader_errors.load();
+	uint64_t total_wins = 0;
+	for (uint64_t w : wins) {
+		total_wins += w;
+	}
+	failures += total_wins != N;
+	failures += set.size() != N;
+	std::vector<uint32_t> listed;
+	for (uint32_t i = 0; i < N; ++i) {
+		listed.push_back(set[i]);
+	}
+	std::sort(listed.begin(), listed.end());
+	for (uint32_t i = 0; i < N; ++i) {
+		failures += listed[i] != i;
+	}
+
+	set.clear();
+	failures += !set.is_empty() || set.contains(0) || set.uniform_select(0.5) != set.NO_VALUE;
+	return failures;
+}
+
+// inserts of random elements, split evenly across 1..max_threads threads
+void scaling_benchmark(uint32_t N, int max_threads)
+{
+	const uint64_t ops_per_thread = 4000000;
+	std::cout << "insert/contains scaling, capacity " << N << std::endl;
+	std::cout << std::setw(8) << "threads" << std::setw(16) << "Mops/s" << std::endl;
+	for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+		concurrent_fast_set<uint32_t> set(N);
+		std::atomic<uint64_t> hits(0);
+		timer t;
+		t.start();
+		std::vector<std::thread> threads;
+		for (int i = 0; i < num_threads; ++i) {
+			threads.push_back(std::thread([&, i]() {
+				superkiss64 rng(i + 1, 2 * i + 3, 5 * i + 7);
+				uint64_t local_hits = 0;
+				for (uint64_t k = 0; k < ops_per_thread; ++k) {
+					uint32_t e = uint32_t(rng.rand() % N);
+					local_hits += (k & 1) ? set.insert(e) : set.contains(e);
+				}
+				hits += local_hits;
+			}));
+		}
+		for (auto& th : threads) {
+			th.join();
+		}
+		double seconds = timer::to_milliseconds(t.stop()) / 1000.0;
+		std::cout << std::setw(8) << num_threads << std::setw(16) << (num_threads * ops_per_thread / seconds / 1e6) << std::endl;
+	}
+}
+
+int main()
+{
+	int hw = std::max(2, int(std::thread::hardware_concurrency()));
+
+	int failures = 0;
+	for (int num_threads : {1, 2, hw, 2 * hw}) {
+		failures += stress_test(num_threads, 100000);
+	}
+	std::cout << failures << " failures" << std::endl;
+
+	scaling_benchmark(1u << 24, hw);
+	return failures == 0 ? 0 : 1;
+}
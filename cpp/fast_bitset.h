@@ -0,0 +1,326 @@
+// fast_bitset.h
+
+/***
+fast_bitset<T>(N) is a fast_set<T>(N) that additionally keeps a packed bitmap of N bits, one per
+element of the universe [0,N).  The bitmap costs N/8 bytes on top of the fast_set storage, and
+buys word-parallel set algebra: the bitmaps of two sets over the same universe are combined 64
+(or 256/512, with AVX2/AVX-512) elements per instruction, see bitops.h.
+
+Let S = fast_bitset<T>(N), n = |S|, and m = |other|.  In addition to the fast_set operations:
+
+O(1) contains(e), a single bit test
+O(min(n, N/64)) clear()
+O(N/64) intersection_size(other) and intersects(other), no element list is touched
+O(N/64 + n) S &= other, S -= other (or O(m) when other is the smaller set)
+O(N/64 + m) S |= other (or O(m) when other is the smaller set)
+O(N) S & other, S | other, S - other, these construct a new set of capacity N
+O(N/64 + n) ordered enumeration, by for_each_ordered(f) or ordered_cbegin()/ordered_cend()
+
+Both operands of a binary operation must have the same capacity.
+***/
+
+#ifndef _FAST_BITSET_INCLUDED_
+#define _FAST_BITSET_INCLUDED_
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+#include "bitops.h"
+#include "fast_set.h"
+
+template <typename UnsignedIntType>
+class fast_bitset {
+	public:
+		typedef typename fast_set<UnsignedIntType>::const_iterator const_iterator;
+		typedef UnsignedIntType element_type;
+
+		const_iterator cbegin() const
+		{
+			return _set.cbegin();
+		}
+
+		const_iterator cend() const
+		{
+			return _set.cend();
+		}
+
+		fast_bitset(UnsignedIntType capacity) :
+			_set(capacity),
+			_bits(bitops::words_for(capacity), 0)
+		{
+		}
+
+		bool insert(UnsignedIntType element)
+		{
+			if (!_set.insert(element)) {
+				return false;
+			}
+			_bits[element / bitops::WORD_BITS] |= bitops::bit(element);
+			return true;
+		}
+
+		bool remove(UnsignedIntType element)
+		{
+			if (!_set.remove(element)) {
+				return false;
+			}
+			_bits[element / bitops::WORD_BITS] &= ~bitops::bit(element);
+			return true;
+		}
+
+		bool contains(UnsignedIntType element) const
+		{
+			assert(element < _set.capacity());
+
+			return (_bits[element / bitops::WORD_BITS] & bitops::bit(element)) != 0;
+		}
+
+		// O(min(n, N/64)): the bitmap must be cleared, either bit by bit or word by word
+		void clear()
+		{
+			if (_set.size() < _bits.size()) {
+				for (auto it = _set.cbegin(); it != _set.cend(); ++it) {
+					_bits[*it / bitops::WORD_BITS] = 0;
+				}
+			} else {
+				std::fill(_bits.begin(), _bits.end(), 0);
+			}
+			_set.clear();
+		}
+
+		bool is_empty() const
+		{
+			return _set.is_empty();
+		}
+
+		uint64_t size() const
+		{
+			return _set.size();
+		}
+
+		uint64_t capacity() const
+		{
+			return _set.capacity();
+		}
+
+		const UnsignedIntType& operator[](UnsignedIntType i) const
+		{
+			return _set[i];
+		}
+
+		UnsignedIntType uniform_select(double p)
+		{
+			return _set.uniform_select(p);
+		}
+
+		// the packed bitmap, bit e of word e/64 is set iff e is in the set
+		const uint64_t* words() const
+		{
+			return _bits.data();
+		}
+
+		size_t num_words() const
+		{
+			return _bits.size();
+		}
+
+		uint64_t intersection_size(const fast_bitset& other) const
+		{
+			assert(capacity() == other.capacity());
+
+			return bitops::popcount_and(_bits.data(), other._bits.data(), _bits.size());
+		}
+
+		bool intersects(const fast_bitset& other) const
+		{
+			assert(capacity() == other.capacity());
+
+			return bitops::any_and(_bits.data(), other._bits.data(), _bits.size());
+		}
+
+		template <typename Function>
+		void for_each_ordered(Function f) const
+		{
+			bitops::for_each_bit(_bits.data(), _bits.size(), [&f](uint64_t e) { f(UnsignedIntType(e)); });
+		}
+
+		// forward iterator over the bitmap, skipping runs of absent elements a word at a time (tzcnt).
+		// Unlike fast_set's ordered iterator it needs no cached view, so it never allocates.
+		class const_ordered_iterator : public std::iterator<
+			std::forward_iterator_tag,
+			UnsignedIntType>
+		{
+			public:
+				const_ordered_iterator() : ref_set(nullptr), word_index(0), word(0)
+				{
+				}
+
+				const_ordered_iterator(const fast_bitset<UnsignedIntType>* set, bool endFlag = false) :
+					ref_set(set), word_index(set->_bits.size()), word(0)
+				{
+					// an empty universe has no words: its begin is its end
+					if (!endFlag && !ref_set->_bits.empty()) {
+						word_index = 0;
+						word = ref_set->_bits[0];
+						skip_empty_words();
+					}
+				}
+
+				const_ordered_iterator operator++()
+				{
+					if (ref_set != nullptr && word != 0) {
+						word &= word - 1;
+						skip_empty_words();
+					}
+					return *this;
+				}
+
+				const_ordered_iterator operator++(int)
+				{
+					const_ordered_iterator tmp(*this); operator++(); return tmp;
+				}
+
+				UnsignedIntType operator*() const
+				{
+					if (ref_set == nullptr || word == 0) {
+						throw iterator_not_dereferenceable_exception();
+					}
+					return UnsignedIntType(word_index * bitops::WORD_BITS + bitops::ctz(word));
+				}
+
+			private:
+				const fast_bitset<UnsignedIntType>* ref_set;
+				size_t word_index;
+				uint64_t word;			// the unvisited bits of _bits[word_index]
+
+				void skip_empty_words()
+				{
+					while (word == 0 && ++word_index < ref_set->_bits.size()) {
+						word = ref_set->_bits[word_index];
+					}
+				}
+
+			friend bool operator==(const const_ordered_iterator& a, const const_ordered_iterator& b)
+			{
+				return a.ref_set == b.ref_set && a.word_index == b.word_index && a.word == b.word;
+			}
+
+			friend bool operator!=(const const_ordered_iterator& a, const const_ordered_iterator& b)
+			{
+				return !(a == b);
+			}
+		};
+
+		const_ordered_iterator ordered_cbegin() const
+		{
+			return const_ordered_iterator(this);
+		}
+
+		const_ordered_iterator ordered_cend() const
+		{
+			return const_ordered_iterator(this, true);
+		}
+
+		fast_bitset& operator&=(const fast_bitset& other)
+		{
+			assert(capacity() == other.capacity());
+
+			bitops::and_assign(_bits.data(), other._bits.data(), _bits.size());
+			drop_cleared_elements();
+			return *this;
+		}
+
+		fast_bitset& operator-=(const fast_bitset& other)
+		{
+			assert(capacity() == other.capacity());
+
+			if (other.size() < size()) {
+				for (auto it = other.cbegin(); it != other.cend(); ++it) {
+					remove(*it);
+				}
+				return *this;
+			}
+			bitops::andnot_assign(_bits.data(), other._bits.data(), _bits.size());
+			drop_cleared_elements();
+			return *this;
+		}
+
+		fast_bitset& operator|=(const fast_bitset& other)
+		{
+			assert(capacity() == other.capacity());
+
+			if (other.size() * bitops::WORD_BITS < capacity()) {
+				for (auto it = other.cbegin(); it != other.cend(); ++it) {
+					insert(*it);
+				}
+				return *this;
+			}
+			for (size_t i = 0; i < _bits.size(); ++i) {
+				uint64_t added = other._bits[i] & ~_bits[i];
+				_bits[i] |= added;
+				while (added != 0) {
+					_set.insert(UnsignedIntType(i * bitops::WORD_BITS + bitops::ctz(added)));
+					added &= added - 1;
+				}
+			}
+			return *this;
+		}
+
+		friend fast_bitset operator&(const fast_bitset& a, const fast_bitset& b)
+		{
+			fast_bitset result(a.capacity(), a._bits);
+			bitops::and_assign(result._bits.data(), b._bits.data(), result._bits.size());
+			result.assign_elements_from_bits();
+			return result;
+		}
+
+		friend fast_bitset operator|(const fast_bitset& a, const fast_bitset& b)
+		{
+			fast_bitset result(a.capacity(), a._bits);
+			bitops::or_assign(result._bits.data(), b._bits.data(), result._bits.size());
+			result.assign_elements_from_bits();
+			return result;
+		}
+
+		friend fast_bitset operator-(const fast_bitset& a, const fast_bitset& b)
+		{
+			fast_bitset result(a.capacity(), a._bits);
+			bitops::andnot_assign(result._bits.data(), b._bits.data(), result._bits.size());
+			result.assign_elements_from_bits();
+			return result;
+		}
+
+	private:
+		fast_set<UnsignedIntType>	_set;
+		std::vector<uint64_t>		_bits;
+
+		// an empty element list with a preset bitmap, used only by the binary operators
+		fast_bitset(uint64_t capacity, const std::vector<uint64_t>& bits) :
+			_set(UnsignedIntType(capacity)),
+			_bits(bits)
+		{
+		}
+
+		// the element list must be empty: insert every element whose bit is set
+		void assign_elements_from_bits()
+		{
+			assert(_set.is_empty());
+
+			bitops::for_each_bit(_bits.data(), _bits.size(), [this](uint64_t e) { _set.insert(UnsignedIntType(e)); });
+		}
+
+		// the bitmap has been narrowed: remove every listed element whose bit is clear.  Walking the
+		// list backwards is safe, remove() only moves the (already visited) last element into the hole.
+		void drop_cleared_elements()
+		{
+			for (uint64_t i = _set.size(); i-- > 0; ) {
+				UnsignedIntType e = _set[UnsignedIntType(i)];
+				if (!contains(e)) {
+					_set.remove(e);
+				}
+			}
+		}
+};
+
+#endif //_FAST_BITSET_INCLUDED_
@@ -0,0 +1,110 @@
+// fast_bitset_test.cpp
+
+// build: g++ -std=c++14 -O2 -march=native fast_bitset_test.cpp -o fast_bitset_test
+
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "fast_bitset.h"
+#include "superkiss64.h"
+
+template <typename T>
+std::set<T> to_std_set(const fast_bitset<T>& s)
+{
+	return std::set<T>(s.cbegin(), s.cend());
+}
+
+template <typename T>
+bool agrees(const fast_bitset<T>& s, const std::set<T>& expected)
+{
+	if (s.size() != expected.size() || to_std_set(s) != expected) {
+		return false;
+	}
+	for (uint64_t e = 0; e < s.capacity(); ++e) {
+		if (s.contains(T(e)) != (expected.count(T(e)) > 0)) {
+			return false;
+		}
+	}
+	std::vector<T> ordered;
+	s.for_each_ordered([&ordered](T e) { ordered.push_back(e); });
+	std::vector<T> iterated;
+	for (auto it = s.ordered_cbegin(); it != s.ordered_cend(); ++it) {
+		iterated.push_back(*it);
+	}
+	return std::vector<T>(expected.begin(), expected.end()) == ordered && ordered == iterated;
+}
+
+template <typename T>
+void random_fill(fast_bitset<T>& s, std::set<T>& mirror, superkiss64& rng, double p)
+{
+	for (uint64_t e = 0; e < s.capacity(); ++e) {
+		if (rng.rand01() < p) {
+			s.insert(T(e));
+			mirror.insert(T(e));
+		}
+	}
+}
+
+int main()
+{
+	std::random_device rd;
+	superkiss64 rng(rd(), rd(), rd());
+
+	const uint16_t N = 1000;
+	const double fill[] = {0.001, 0.05, 0.5, 0.95};
+	int failures = 0;
+
+	for (double pa : fill) {
+		for (double pb : fill) {
+			fast_bitset<uint16_t> a(N), b(N);
+			std::set<uint16_t> sa, sb, expected;
+			random_fill(a, sa, rng, pa);
+			random_fill(b, sb, rng, pb);
+
+			std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(), std::inserter(expected, expected.end()));
+			failures += !agrees(a & b, expected);
+			failures += a.intersection_size(b) != expected.size();
+			failures += a.intersects(b) != !expected.empty();
+			fast_bitset<uint16_t> c = a;
+			c &= b;
+			failures += !agrees(c, expected);
+
+			expected.clear();
+			std::set_union(sa.begin(), sa.end(), sb.begin(), sb.end(), std::inserter(expected, expected.end()));
+			failures += !agrees(a | b, expected);
+			c = a;
+			c |= b;
+			failures += !agrees(c, expected);
+
+			expected.clear();
+			std::set_difference(sa.begin(), sa.end(), sb.begin(), sb.end(), std::inserter(expected, expected.end()));
+			failures += !agrees(a - b, expected);
+			c = a;
+			c -= b;
+			failures += !agrees(c, expected);
+		}
+	}
+
+	// the empty universe: nothing to enumerate, and the set algebra still works
+	fast_bitset<uint32_t> none(0);
+	failures += !agrees(none, std::set<uint32_t>());
+	failures += none.ordered_cbegin() != none.ordered_cend();
+	failures += !agrees(none & none, std::set<uint32_t>());
+	failures += none.intersects(none);
+
+	fast_bitset<uint8_t> small(50);
+	small.insert(45);
+	small.insert(17);
+	small.insert(5);
+	small.remove(17);
+	std::cout << "small set = {";
+	small.for_each_ordered([](uint8_t e) { std::cout << ' ' << (uint64_t)e; });
+	std::cout << " }" << std::endl;
+
+	std::cout << failures << " failures" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -4,21 +4,29 @@
 Let T be an unsigned integral type other than bool.  Then fast_set<T>(N) can represent a set of 
 elements of type T, in the range [0,N), or [0,N-1] where N < T::max_value.  We do this
 using two vectors of size N: one is an elements list, the list of the elements currently 
-present in the list.  The other is a list of positions of the elements in the elements list,
-such that: positions[e] == T::max_value indicates that element e is NOT in the set, and 
-positions[e] == X indicates that element e is in position X of the elements list.  
+present in the list.  The other is a list of positions of the elements in the elements list:
+element e is in the set iff positions[e] == X, X < n, and elements[X] == e.  Membership is
+validated against the elements list (the sparse set of Briggs & Torczon), so a stale positions
+entry is harmless: clear() just forgets the elements list, and positions never needs resetting.
 
 Note: to keep memory usage under control, T should be the smallest unsigned integer type that can hold N.
 
 Let S = fast_set<T>(N), where N is the capacity of the set, and n = |S|, and e \in S.  This container provides:
 
-O(1) insert(e), remove(e), and contains(e)
+O(1) insert(e), remove(e), contains(e), and clear()
 O(n) enumerations (no order guarantees)
-O(N) ordered enumerations (guaranteed *it < *(it+1))
+O(min(n + N/64, n sizeof(T))) ordered enumerations (guaranteed *it < *(it+1)), O(n) while the set is unchanged
 O(1) access to unordered list of elements, consequently O(1) uniform selection
-O(2N) words of storage
+O(k) batch insert_many, remove_many, contains_many of k elements, prefetching ahead of the lookups
+O(2N) words of storage, plus the cache of the ordered view once an ordered enumeration is made: up to
+2n words (the view and a radix sort buffer) and N/64 bitmap words
+
+The ordered view is cached in mutable members, built by the first ordered enumeration after a change:
+const access is not thread-safe.  Threads sharing a set, even read only, must synchronize its ordered
+enumerations, or each enumerate their own copy.
 ------------------------
-O(N) union, intersection and difference (not currently implemented).
+Union, intersection and difference are provided by fast_bitset<T> (fast_bitset.h), which keeps
+a packed bitmap alongside the fast_set and combines sets a machine word (or vector) at a time.
 ***/
 
 
@@ -26,9 +34,25 @@ O(N) union, intersection and difference (not currently implemented).
 #define _FAST_SET_INCLUDED_
 
 #include <vector>
+#include <iostream>
+#include <cstdint>
 #include <iterator>
+#include <algorithm>
 #include <stdexcept>
 #include <cassert>
+#include <climits>
+#include <type_traits>
+
+#include "bitops.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FAST_SET_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_MSC_VER)
+#include <xmmintrin.h>
+#define FAST_SET_PREFETCH(address) _mm_prefetch((const char*)(address), _MM_HINT_T0)
+#else
+#define FAST_SET_PREFETCH(address)
+#endif
 
 class iterator_not_dereferenceable_exception : public std::runtime_error
 {
@@ -63,7 +87,11 @@ class fast_set {
 			_capacity(UnsignedIntType(-1)-1),
 			_num_elements(0),
 			_elements(_capacity),
-			_positions(_capacity, UnsignedIntType(-1))
+			_positions(_capacity, UnsignedIntType(-1)),
+			_ordered(),
+			_ordered_scratch(),
+			_ordered_bits(),
+			_ordered_valid(false)
 		{
 			assert(_capacity < UnsignedIntType(-1));
 		}
@@ -72,7 +100,11 @@ class fast_set {
 			_capacity(capacity),
 			_num_elements(0),
 			_elements(_capacity),
-			_positions(_capacity, UnsignedIntType(-1))
+			_positions(_capacity, UnsignedIntType(-1)),
+			_ordered(),
+			_ordered_scratch(),
+			_ordered_bits(),
+			_ordered_valid(false)
 		{
 			assert(_capacity < UnsignedIntType(-1));
 		}
@@ -86,11 +118,12 @@ class fast_set {
 			assert(element >= 0 && element < _capacity);
 			assert(_num_elements >= 0 && _num_elements <= _capacity);
 
-			if (_positions[element] != NO_VALUE) {
+			if (contains(element)) {
 				return false;
 			}
 			_positions[element] = _num_elements;
 			_elements[_num_elements++] = element;
+			_ordered_valid = false;
 			return true;
 		}
 
@@ -99,18 +132,18 @@ class fast_set {
 			assert(element >= 0 && element < _capacity);
 			assert(_num_elements >= 0 && _num_elements <= _capacity);
 
-			UnsignedIntType remove_pos = _positions[element];	// where is the element to remove?
-			if (remove_pos == NO_VALUE) {
+			if (!contains(element)) {
 				return false;
 			}
 			// Use the old trick: overwrite the removed element with the last_element, decrement the element count,
-			// update the position of the removed element to NO_VALUE, and finally set the position of the last_element
-			// to the position of the removed element.  There is a subtle bug if the removed element ==  last_element,
-			// so we always want to set _positions[element] = NO_VALUE last to avoid the decision element != last_element.
+			// and set the position of the last_element to the position of the removed element.  The removed
+			// element's own position is left stale, it now points at or past the end of the elements list, or at
+			// a slot holding a different element, so contains() rejects it.  This also covers element == last_element.
+			UnsignedIntType remove_pos = _positions[element];			// where is the element to remove?
 			UnsignedIntType last_element = _elements[--_num_elements];		// what is the last_element?
 			_positions[last_element] = remove_pos;					// set last_element's position to where the removed element was
 			_elements[remove_pos] = last_element;					// place the last element where removed element was
-			_positions[element] = NO_VALUE;							// remove the element
+			_ordered_valid = false;
 			return true;
 		}
 
@@ -119,7 +152,108 @@ class fast_set {
 			assert(element >= 0 && element < _capacity);
 			assert(_num_elements >= 0 && _num_elements <= _capacity);
 
-			return _positions[element] != NO_VALUE;
+			UnsignedIntType pos = _positions[element];
+			return pos < _num_elements && _elements[pos] == element;
+		}
+
+		// O(1), independent of capacity: the positions list is left as is, see contains()
+		void clear()
+		{
+			_num_elements = 0;
+			_ordered_valid = false;
+		}
+
+		// Batch operations over a list of elements.  _positions[e] is a random access that misses cache
+		// on nearly every call once the set outgrows L2, so these loops prefetch the positions entry
+		// PREFETCH_DISTANCE elements ahead, overlapping the misses instead of serializing them.
+
+		// inserts elements[0..count), returns the number of elements that were not already present
+		uint64_t insert_many(const UnsignedIntType* elements, size_t count)
+		{
+			uint64_t inserted = 0;
+			for (size_t i = 0; i < count; ++i) {
+				if (i + PREFETCH_DISTANCE < count) {
+					FAST_SET_PREFETCH(&_positions[elements[i + PREFETCH_DISTANCE]]);
+				}
+				inserted += insert(elements[i]);
+			}
+			return inserted;
+		}
+
+		// removes elements[0..count), returns the number of elements that were present
+		uint64_t remove_many(const UnsignedIntType* elements, size_t count)
+		{
+			uint64_t removed = 0;
+			for (size_t i = 0; i < count; ++i) {
+				if (i + PREFETCH_DISTANCE < count) {
+					FAST_SET_PREFETCH(&_positions[elements[i + PREFETCH_DISTANCE]]);
+				}
+				removed += remove(elements[i]);
+			}
+			return removed;
+		}
+
+		// sets bit i%64 of mask[i/64] iff elements[i] is in the set, for i in [0,count), and returns
+		// the number of members found.  mask must hold (count+63)/64 words.  For 32-bit sets compiled
+		// with AVX2 the positions are fetched 8 at a time with a gather.
+		uint64_t contains_many(const UnsignedIntType* elements, size_t count, uint64_t* mask) const
+		{
+			uint64_t found = 0;
+			size_t i = 0;
+#if defined(__AVX2__)
+			if (std::is_same<UnsignedIntType, uint32_t>::value && _capacity <= uint64_t(INT32_MAX) && _num_elements > 0) {
+				const int* positions = reinterpret_cast<const int*>(_positions.data());
+				const int* listed = reinterpret_cast<const int*>(_elements.data());
+				const __m256i last_pos = _mm256_set1_epi32(int(_num_elements - 1));
+				for (; i + 8 <= count; i += 8) {
+					if (i + PREFETCH_DISTANCE + 8 <= count) {
+						for (size_t j = i + PREFETCH_DISTANCE; j < i + PREFETCH_DISTANCE + 8; ++j) {
+							FAST_SET_PREFETCH(&_positions[elements[j]]);
+						}
+					}
+					__m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(elements + i));
+					__m256i pos = _mm256_i32gather_epi32(positions, idx, 4);
+					__m256i in_range = _mm256_cmpeq_epi32(_mm256_min_epu32(pos, last_pos), pos);	// pos < n, unsigned
+					__m256i safe_pos = _mm256_and_si256(pos, in_range);				// out of range lanes read _elements[0]
+					__m256i elem = _mm256_i32gather_epi32(listed, safe_pos, 4);
+					__m256i member = _mm256_and_si256(in_range, _mm256_cmpeq_epi32(elem, idx));
+					uint64_t hits = uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(member)));
+					if (i % 64 == 0) {
+						mask[i / 64] = 0;
+					}
+					mask[i / 64] |= hits << (i % 64);
+					found += bitops::popcount(hits);
+				}
+			}
+#endif
+			for (; i < count; ++i) {
+				if (i + PREFETCH_DISTANCE < count) {
+					FAST_SET_PREFETCH(&_positions[elements[i + PREFETCH_DISTANCE]]);
+				}
+				if (i % 64 == 0) {
+					mask[i / 64] = 0;
+				}
+				uint64_t hit = contains(elements[i]);
+				mask[i / 64] |= hit << (i % 64);
+				found += hit;
+			}
+			return found;
+		}
+
+		uint64_t insert_many(const std::vector<UnsignedIntType>& elements)
+		{
+			return insert_many(elements.data(), elements.size());
+		}
+
+		uint64_t remove_many(const std::vector<UnsignedIntType>& elements)
+		{
+			return remove_many(elements.data(), elements.size());
+		}
+
+		uint64_t contains_many(const std::vector<UnsignedIntType>& elements, std::vector<uint64_t>& mask) const
+		{
+			mask.resize(bitops::words_for(elements.size()));
+			return contains_many(elements.data(), elements.size(), mask.data());
 		}
 
 		bool is_empty() const
@@ -166,6 +300,30 @@ class fast_set {
 			return _capacity;
 		}
 
+		enum class ordered_path { adaptive, bitmap, sort };
+
+		// Returns the elements in increasing order.  The view is cached and stays valid until the next
+		// successful insert, remove or clear, so repeated ordered enumerations of an unchanged set cost O(n).
+		// Building the view either marks the elements in a bitmap and walks it with tzcnt, O(n + N/64), which
+		// wins for dense sets, or radix sorts the element list, O(n * sizeof(T)), which wins for sparse sets.
+		// The adaptive path picks the bitmap once the set is at least 1/ORDERED_BITMAP_RATIO full.
+		// Not thread-safe, although const: building the view writes the cache.
+		const std::vector<UnsignedIntType>& ordered_elements(ordered_path how = ordered_path::adaptive) const
+		{
+			if (!_ordered_valid) {
+				if (how == ordered_path::adaptive) {
+					how = (_num_elements * ORDERED_BITMAP_RATIO >= _capacity ? ordered_path::bitmap : ordered_path::sort);
+				}
+				if (how == ordered_path::bitmap) {
+					bitmap_ordered();
+				} else {
+					sort_ordered();
+				}
+				_ordered_valid = true;
+			}
+			return _ordered;
+		}
+
 		void show() const
 		{
 			std::cout << "size: " << uint64_t(_num_elements) << std::endl;
@@ -178,7 +336,7 @@ class fast_set {
 			}
 			std::cout << std::endl << "positions: ";
 			for (UnsignedIntType i = 0; i < _capacity; ++i) {
-				if (_positions[i] == NO_VALUE) {
+				if (!contains(i)) {
 					std::cout << '-';
 				} else {
 					std::cout << uint64_t(_positions[i]);
@@ -196,37 +354,77 @@ class fast_set {
 		std::vector<UnsignedIntType>	_elements;
 		std::vector<UnsignedIntType>	_positions;
 
-		const UnsignedIntType NO_VALUE = -1;
+		mutable std::vector<UnsignedIntType>	_ordered;			// cached ordered view of _elements
+		mutable std::vector<UnsignedIntType>	_ordered_scratch;	// radix sort buffer
+		mutable std::vector<uint64_t>			_ordered_bits;		// bitmap for the dense path
+		mutable bool							_ordered_valid;
+
+		static const uint64_t ORDERED_BITMAP_RATIO = 64;
+		static const size_t PREFETCH_DISTANCE = 16;
+
+		// mark the elements in a scratch bitmap of N bits, then walk it a word at a time with tzcnt
+		void bitmap_ordered() const
+		{
+			_ordered_bits.assign(bitops::words_for(_capacity), 0);
+			for (uint64_t i = 0; i < _num_elements; ++i) {
+				_ordered_bits[_elements[i] / bitops::WORD_BITS] |= bitops::bit(_elements[i]);
+			}
+			_ordered.resize(_num_elements);
+			UnsignedIntType* out = _ordered.data();
+			bitops::for_each_bit(_ordered_bits.data(), _ordered_bits.size(), [&out](uint64_t e) { *out++ = UnsignedIntType(e); });
+		}
+
+		// LSD radix sort, one counting pass per significant byte of the largest possible element
+		void sort_ordered() const
+		{
+			_ordered.assign(cbegin(), cend());
+			if (_num_elements < 64) {
+				std::sort(_ordered.begin(), _ordered.end());
+				return;
+			}
+			_ordered_scratch.resize(_num_elements);
+			for (unsigned shift = 0; shift < 8 * sizeof(UnsignedIntType) && ((_capacity - 1) >> shift) != 0; shift += 8) {
+				uint64_t offsets[257] = {0};
+				for (auto it = _ordered.begin(); it != _ordered.end(); ++it) {
+					++offsets[((*it >> shift) & 0xFF) + 1];
+				}
+				for (int b = 0; b < 256; ++b) {
+					offsets[b + 1] += offsets[b];
+				}
+				for (auto it = _ordered.begin(); it != _ordered.end(); ++it) {
+					_ordered_scratch[offsets[(*it >> shift) & 0xFF]++] = *it;
+				}
+				_ordered.swap(_ordered_scratch);
+			}
+		}
 		
 		
 	public:
 		#ifdef ordered_iterator_impl
+		// The ordered iterator walks the cached ordered_elements() view, so the set must not be
+		// modified while an ordered iterator is in use.
 		class const_ordered_iterator : public std::iterator<
 			std::bidirectional_iterator_tag,
 			UnsignedIntType>
 		{
 			public:
 				// default ctor: uninitialized iterator, nothing should work except to assign to this object
-				const_ordered_iterator() : ref_set(nullptr), pos(0), first(0)
+				const_ordered_iterator() : ref_set(nullptr), pos(0)
 				{
 				}
 
 				// copy ctor
-				const_ordered_iterator(const const_ordered_iterator& ref) : ref_set(ref.ref_set), pos(ref.pos), first(ref.first)
+				const_ordered_iterator(const const_ordered_iterator& ref) : ref_set(ref.ref_set), pos(ref.pos)
 				{
 				}
 			
 				// constructor guaranteed to point to first dereferenceable element (ie: begin()),  or end()
 				const_ordered_iterator(const fast_set<UnsignedIntType>* set, bool endFlag = false) :
-					ref_set(set), pos(0), first(0)
+					ref_set(set), pos(0)
 				{
-					// find the first dereferenceable position, and mark it as first
-					while (pos < ref_set->capacity() && ref_set->_positions[pos] == UnsignedIntType(-1)) {
-						++pos;
-					}
-					first = pos;
+					const std::vector<UnsignedIntType>& ordered = ref_set->ordered_elements();
 					if (endFlag) {	// flag the end() iterator appropriately
-						pos = ref_set->capacity();
+						pos = ordered.size();
 					}
 				}
 				
@@ -235,8 +433,8 @@ class fast_set {
 					if (this != &other) {
 						ref_set = other.ref_set;
 						pos = other.pos;
-						first = other.first;
 					}
+					return *this;
 				}
 
 				~const_ordered_iterator()
@@ -245,8 +443,8 @@ class fast_set {
 
 				const_ordered_iterator operator++()
 				{
-					if (ref_set != nullptr) {
-						while (++pos < ref_set->capacity() && ref_set->_positions[pos] == UnsignedIntType(-1));
+					if (ref_set != nullptr && pos < ref_set->_ordered.size()) {
+						++pos;
 					}
 					return *this;
 				}
@@ -276,29 +474,28 @@ class fast_set {
 
 				const_ordered_iterator operator--()
 				{
-					if (ref_set != nullptr && pos > first) {
-						while (--pos > first && ref_set->_positions[pos] == UnsignedIntType(-1));
+					if (ref_set != nullptr && pos > 0) {
+						--pos;
 					}
 					return *this;
 				}
 
 				const_ordered_iterator operator--(int)
 				{
-					const_ordered_iterator tmp(this); operator--(); return tmp;
+					const_ordered_iterator tmp(*this); operator--(); return tmp;
 				}
 
 				UnsignedIntType operator*() const
 				{
-					if (ref_set == nullptr) {	// if there is no container, there is nothing we can do but throw
+					if (ref_set == nullptr || pos >= ref_set->_ordered.size()) {	// no container, or end(): nothing we can do but throw
 						throw iterator_not_dereferenceable_exception();
 					}
-					return pos;
+					return ref_set->_ordered[pos];
 				}
 
 			private:
 				const fast_set<UnsignedIntType>* ref_set;
-				UnsignedIntType pos;
-				UnsignedIntType first;
+				uint64_t pos;
 
 			friend bool operator==(const fast_set<UnsignedIntType>::const_ordered_iterator& a, const fast_set<UnsignedIntType>::const_ordered_iterator& b)
 			{
@@ -0,0 +1,241 @@
+// fast_set_bench.cpp
+
+// build: g++ -std=c++17 -O2 -march=native fast_set_bench.cpp -o fast_set_bench
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#define ordered_iterator_impl
+#include "fast_set.h"
+#include "fast_bitset.h"
+#include "static_fast_set.h"
+
+#include "superkiss64.h"
+#include "timer.h"
+
+// keeps the optimizer from discarding the benchmarked work
+volatile uint64_t sink;
+
+// Ordered enumeration of a capacity 65534 set, at increasing fill ratios.  Each path is timed
+// from an invalidated cache, ie: the cost of the first ordered enumeration after a mutation.
+//   scan   : test every element of the capacity (the original const_ordered_iterator)
+//   bitmap : mark the elements in a scratch bitmap, then walk it with tzcnt
+//   sort   : radix sort the element list
+//   auto   : whatever ordered_elements() picks
+//   fbs    : fast_bitset tzcnt walk of its own bitmap
+void bench_ordered_iteration(superkiss64& rng)
+{
+	typedef fast_set<uint16_t>::ordered_path ordered_path;
+	const uint16_t N = 65534;
+	const int reps = 200;
+	const double fill[] = {0.0001, 0.001, 0.01, 0.03, 0.06, 0.1, 0.3, 0.9};
+
+	std::cout << "ordered iteration, capacity " << N << ", ns per enumeration" << std::endl;
+	std::cout << std::setw(8) << "fill" << std::setw(12) << "scan" << std::setw(12) << "bitmap"
+			  << std::setw(12) << "sort" << std::setw(12) << "auto" << std::setw(12) << "fbs" << std::endl;
+
+	for (double p : fill) {
+		fast_set<uint16_t> set(N);
+		fast_bitset<uint16_t> bits(N);
+		for (uint64_t e = 0; e < N; ++e) {
+			if (rng.rand01() < p) {
+				set.insert(uint16_t(e));
+				bits.insert(uint16_t(e));
+			}
+		}
+		uint16_t probe = 0;
+		while (set.contains(probe)) {
+			++probe;
+		}
+
+		double ns[5];
+		timer t(true);
+		t.start();
+		for (int r = 0; r < reps; ++r) {
+			uint64_t sum = 0;
+			for (uint64_t e = 0; e < N; ++e) {
+				if (set.contains(uint16_t(e))) {
+					sum += e;
+				}
+			}
+			sink += sum;
+		}
+		ns[0] = timer::to_nanoseconds(t.stop()) / reps;
+
+		const ordered_path paths[] = {ordered_path::bitmap, ordered_path::sort, ordered_path::adaptive};
+		for (int path = 0; path < 3; ++path) {
+			t.start();
+			for (int r = 0; r < reps; ++r) {
+				set.insert(probe);				// invalidate the cached view
+				set.remove(probe);
+				sink += set.ordered_elements(paths[path]).size();
+			}
+			ns[path + 1] = timer::to_nanoseconds(t.stop()) / reps;
+		}
+
+		t.start();
+		for (int r = 0; r < reps; ++r) {
+			uint64_t sum = 0;
+			for (auto it = bits.ordered_cbegin(); it != bits.ordered_cend(); ++it) {
+				sum += *it;
+			}
+			sink += sum;
+		}
+		ns[4] = timer::to_nanoseconds(t.stop()) / reps;
+
+		std::cout << std::setw(8) << p;
+		for (int i = 0; i < 5; ++i) {
+			std::cout << std::setw(12) << ns[i];
+		}
+		std::cout << std::endl;
+	}
+}
+
+// A random mix of insert/remove/contains over a small universe (the 17-21 vertex graphs of
+// main.cpp), and the cost of copying a set, static_fast_set vs fast_set.
+template <typename Set>
+double time_mixed_ops(Set& set, const std::vector<uint8_t>& ops, const std::vector<uint8_t>& elements)
+{
+	timer t(true);
+	t.start();
+	uint64_t hits = 0;
+	for (size_t i = 0; i < ops.size(); ++i) {
+		switch (ops[i]) {
+			case 0: hits += set.insert(elements[i]); break;
+			case 1: hits += set.remove(elements[i]); break;
+			default: hits += set.contains(elements[i]); break;
+		}
+	}
+	sink += hits;
+	return timer::to_nanoseconds(t.stop()) / ops.size();
+}
+
+template <typename Set>
+double time_copies(const Set& set, int reps)
+{
+	timer t(true);
+	t.start();
+	for (int r = 0; r < reps; ++r) {
+		Set copy = set;
+		copy.insert(uint8_t(r % 21));
+		sink += copy.size();
+	}
+	return timer::to_nanoseconds(t.stop()) / reps;
+}
+
+void bench_static_vs_dynamic(superkiss64& rng)
+{
+	const int N = 21;
+	const size_t num_ops = 10000000;
+	std::vector<uint8_t> ops(num_ops), elements(num_ops);
+	for (size_t i = 0; i < num_ops; ++i) {
+		ops[i] = uint8_t(rng.rand() % 3);
+		elements[i] = uint8_t(rng.rand() % N);
+	}
+
+	static_fast_set<uint8_t, N> s;
+	fast_set<uint8_t> d(N);
+	double static_ns = time_mixed_ops(s, ops, elements);
+	double dynamic_ns = time_mixed_ops(d, ops, elements);
+	std::cout << "mixed insert/remove/contains, capacity " << N << ", ns per op" << std::endl;
+	std::cout << "  static_fast_set: " << static_ns << std::endl;
+	std::cout << "  fast_set       : " << dynamic_ns << std::endl;
+
+	const int reps = 1000000;
+	std::cout << "copy, capacity " << N << ", ns per copy" << std::endl;
+	std::cout << "  static_fast_set: " << time_copies(s, reps) << " (" << sizeof(s) << " bytes)" << std::endl;
+	std::cout << "  fast_set       : " << time_copies(d, reps) << std::endl;
+}
+
+// Membership tests and inserts against a set far larger than L2, one at a time vs batched.
+void bench_batch_operations(superkiss64& rng)
+{
+	const uint32_t N = 1u << 23;
+	const size_t num_queries = 1 << 22;
+	fast_set<uint32_t> set(N);
+	for (uint32_t e = 0; e < N; e += 2) {
+		set.insert(e);
+	}
+	std::vector<uint32_t> queries(num_queries);
+	for (size_t i = 0; i < num_queries; ++i) {
+		queries[i] = uint32_t(rng.rand() % N);
+	}
+	std::vector<uint64_t> mask;
+
+	timer t(true);
+	t.start();
+	uint64_t found = 0;
+	for (size_t i = 0; i < num_queries; ++i) {
+		found += set.contains(queries[i]);
+	}
+	double single_ns = timer::to_nanoseconds(t.stop()) / num_queries;
+	sink += found;
+
+	t.start();
+	sink += set.contains_many(queries, mask);
+	double batch_ns = timer::to_nanoseconds(t.stop()) / num_queries;
+
+	std::cout << "contains, capacity " << N << ", ns per query" << std::endl;
+	std::cout << "  contains     : " << single_ns << std::endl;
+	std::cout << "  contains_many: " << batch_ns << std::endl;
+
+	fast_set<uint32_t> a(N), b(N);
+	t.start();
+	for (size_t i = 0; i < num_queries; ++i) {
+		a.insert(queries[i]);
+	}
+	single_ns = timer::to_nanoseconds(t.stop()) / num_queries;
+	t.start();
+	b.insert_many(queries);
+	batch_ns = timer::to_nanoseconds(t.stop()) / num_queries;
+	sink += a.size() + b.size();
+
+	std::cout << "insert, capacity " << N << ", ns per element" << std::endl;
+	std::cout << "  insert       : " << single_ns << std::endl;
+	std::cout << "  insert_many  : " << batch_ns << std::endl;
+}
+
+// Resetting a scratch set that holds a few elements: clear() vs constructing a fresh set.
+void bench_reset()
+{
+	const int reps = 1000;
+	std::cout << "reset a set of 16 elements, ns per reset" << std::endl;
+	std::cout << std::setw(10) << "capacity" << std::setw(12) << "clear" << std::setw(14) << "reconstruct" << std::endl;
+	for (uint32_t N = 1u << 10; N <= (1u << 22); N <<= 4) {
+		fast_set<uint32_t> set(N);
+		timer t(true);
+		t.start();
+		for (int r = 0; r < reps; ++r) {
+			for (uint32_t e = 0; e < 16; ++e) {
+				set.insert(e * (N / 16));
+			}
+			set.clear();
+		}
+		double clear_ns = timer::to_nanoseconds(t.stop()) / reps;
+
+		t.start();
+		for (int r = 0; r < reps; ++r) {
+			for (uint32_t e = 0; e < 16; ++e) {
+				set.insert(e * (N / 16));
+			}
+			set = fast_set<uint32_t>(N);
+		}
+		double reconstruct_ns = timer::to_nanoseconds(t.stop()) / reps;
+		sink += set.size();
+
+		std::cout << std::setw(10) << N << std::setw(12) << clear_ns << std::setw(14) << reconstruct_ns << std::endl;
+	}
+}
+
+int main()
+{
+	std::random_device rd;
+	superkiss64 rng(rd(), rd(), rd());
+
+	bench_ordered_iteration(rng);
+	bench_static_vs_dynamic(rng);
+	bench_batch_operations(rng);
+	bench_reset();
+}
@@ -0,0 +1,290 @@
+// fast_set_family.h
+
+/***
+fast_set_family<T>(K, N) represents K disjoint sets over one shared universe [0,N): each element
+of the universe belongs to at most one of the sets.  This is the shape of a bucket queue, eg: the
+vertices of a graph bucketed by degree.  Instead of K separate fast_set<T>(N) objects, each with two
+vectors of size N (O(K*N) words and 2K allocations), the family keeps everything in one arena:
+
+	next[N], prev[N]	: each set is a doubly linked list threaded through the universe
+	owner[N]			: the set an element belongs to, or NO_SET
+	head[K], size[K]	: first element and cardinality of each set
+
+Since an element is in at most one list, one next/prev pair per element serves every set.  Let
+F = fast_set_family<T>(K, N), and n = |F[s]|.  This container provides:
+
+O(1) insert(s, e), remove(s, e), remove(e), contains(s, e), owner(e), size(s)
+O(n) enumeration of a set (no order guarantees)
+O(N + K) grow(K'), adds empty sets up to K' sets (eg: when the degrees outgrow the buckets)
+O(3N + 2K) 32-bit words of storage, in a single allocation, so copies are one memcpy
+
+Unlike fast_set there is no O(1) random access into a set, elements are reached by iteration.
+***/
+
+#ifndef _FAST_SET_FAMILY_INCLUDED_
+#define _FAST_SET_FAMILY_INCLUDED_
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cassert>
+
+template <typename UnsignedIntType>
+class fast_set_family {
+
+	static_assert(std::is_unsigned<UnsignedIntType>::value, "Template parameter must be unsigned.");
+	static_assert(!std::is_same<UnsignedIntType, bool>::value, "Template parameter must not be bool.");
+
+	public:
+		typedef UnsignedIntType element_type;
+
+		static const uint32_t NO_SET = uint32_t(-1);
+
+		class const_iterator : public std::iterator<std::forward_iterator_tag, UnsignedIntType>
+		{
+			public:
+				const_iterator() : family(nullptr), pos(NO_VALUE)
+				{
+				}
+
+				const_iterator(const fast_set_family<UnsignedIntType>* f, uint32_t p) : family(f), pos(p)
+				{
+				}
+
+				const_iterator operator++()
+				{
+					pos = family->next_of(pos);
+					return *this;
+				}
+
+				const_iterator operator++(int)
+				{
+					const_iterator tmp(*this); operator++(); return tmp;
+				}
+
+				UnsignedIntType operator*() const
+				{
+					return UnsignedIntType(pos);
+				}
+
+			private:
+				const fast_set_family<UnsignedIntType>* family;
+				uint32_t pos;
+
+			friend bool operator==(const const_iterator& a, const const_iterator& b)
+			{
+				return a.pos == b.pos;
+			}
+
+			friend bool operator!=(const const_iterator& a, const const_iterator& b)
+			{
+				return !(a == b);
+			}
+		};
+
+		// a read only view of one set of the family, valid until the family is destroyed
+		class const_set_view {
+			public:
+				const_set_view(const fast_set_family<UnsignedIntType>* f, uint32_t s) : family(f), set(s)
+				{
+				}
+
+				const_iterator cbegin() const { return family->cbegin(set); }
+				const_iterator cend() const { return family->cend(set); }
+				const_iterator begin() const { return cbegin(); }
+				const_iterator end() const { return cend(); }
+				uint64_t size() const { return family->size(set); }
+				bool is_empty() const { return family->is_empty(set); }
+				bool contains(UnsignedIntType element) const { return family->contains(set, element); }
+
+			private:
+				const fast_set_family<UnsignedIntType>* family;
+				uint32_t set;
+		};
+
+		fast_set_family(uint64_t num_sets, UnsignedIntType capacity) :
+			_num_sets(num_sets),
+			_capacity(capacity),
+			_arena(3 * _capacity + 2 * _num_sets, NO_VALUE)
+		{
+			assert(_num_sets < NO_SET && _capacity < NO_VALUE);
+
+			std::fill(_arena.begin() + size_offset(), _arena.end(), 0);
+		}
+
+		// adds empty sets, so that there are num_sets sets.  Existing sets and memberships are kept.
+		void grow(uint64_t num_sets)
+		{
+			assert(num_sets < NO_SET);
+
+			if (num_sets <= _num_sets) {
+				return;
+			}
+			std::vector<uint32_t> arena(3 * _capacity + 2 * num_sets);
+			auto heads = _arena.begin() + head_offset();
+			auto sizes = _arena.begin() + size_offset();
+			auto it = std::copy(_arena.begin(), heads, arena.begin());
+			it = std::copy(heads, sizes, it);
+			it = std::fill_n(it, num_sets - _num_sets, NO_VALUE);
+			it = std::copy(sizes, _arena.end(), it);
+			std::fill(it, arena.end(), 0);
+			_arena.swap(arena);
+			_num_sets = num_sets;
+		}
+
+		// insert element into set s.  If element is in another set of the family, it is moved.
+		bool insert(uint64_t s, UnsignedIntType element)
+		{
+			assert(s < _num_sets && element < _capacity);
+
+			uint32_t current = owner(element);
+			if (current == s) {
+				return false;
+			}
+			if (current != NO_SET) {
+				unlink(current, element);
+			}
+			uint32_t* next = _arena.data();
+			uint32_t* prev = next + _capacity;
+			uint32_t* head = next + head_offset();
+
+			uint32_t first = head[s];
+			next[element] = first;
+			prev[element] = NO_VALUE;
+			if (first != NO_VALUE) {
+				prev[first] = element;
+			}
+			head[s] = element;
+			owner_array()[element] = uint32_t(s);
+			++size_array()[s];
+			return true;
+		}
+
+		bool remove(uint64_t s, UnsignedIntType element)
+		{
+			assert(s < _num_sets && element < _capacity);
+
+			if (owner(element) != s) {
+				return false;
+			}
+			unlink(uint32_t(s), element);
+			return true;
+		}
+
+		// remove element from whichever set holds it
+		bool remove(UnsignedIntType element)
+		{
+			assert(element < _capacity);
+
+			uint32_t current = owner(element);
+			if (current == NO_SET) {
+				return false;
+			}
+			unlink(current, element);
+			return true;
+		}
+
+		bool contains(uint64_t s, UnsignedIntType element) const
+		{
+			assert(s < _num_sets && element < _capacity);
+
+			return owner(element) == s;
+		}
+
+		// the set holding element, or NO_SET
+		uint32_t owner(UnsignedIntType element) const
+		{
+			assert(element < _capacity);
+
+			return _arena[2 * _capacity + element];
+		}
+
+		uint64_t size(uint64_t s) const
+		{
+			assert(s < _num_sets);
+
+			return _arena[size_offset() + s];
+		}
+
+		bool is_empty(uint64_t s) const
+		{
+			return size(s) == 0;
+		}
+
+		uint64_t num_sets() const
+		{
+			return _num_sets;
+		}
+
+		uint64_t capacity() const
+		{
+			return _capacity;
+		}
+
+		const_iterator cbegin(uint64_t s) const
+		{
+			assert(s < _num_sets);
+
+			return const_iterator(this, _arena[head_offset() + s]);
+		}
+
+		const_iterator cend(uint64_t) const
+		{
+			return const_iterator(this, NO_VALUE);
+		}
+
+		const_set_view operator[](uint64_t s) const
+		{
+			assert(s < _num_sets);
+
+			return const_set_view(this, uint32_t(s));
+		}
+
+	private:
+		uint64_t				_num_sets;
+		uint64_t				_capacity;
+		std::vector<uint32_t>	_arena;		// next[N], prev[N], owner[N], head[K], size[K]
+
+		static const uint32_t NO_VALUE = uint32_t(-1);
+
+		uint64_t head_offset() const { return 3 * _capacity; }
+		uint64_t size_offset() const { return 3 * _capacity + _num_sets; }
+
+		uint32_t* owner_array() { return _arena.data() + 2 * _capacity; }
+		uint32_t* size_array() { return _arena.data() + size_offset(); }
+
+		uint32_t next_of(uint32_t element) const
+		{
+			return _arena[element];
+		}
+
+		void unlink(uint32_t s, uint32_t element)
+		{
+			uint32_t* next = _arena.data();
+			uint32_t* prev = next + _capacity;
+			uint32_t* head = next + head_offset();
+
+			uint32_t n = next[element];
+			uint32_t p = prev[element];
+			if (p != NO_VALUE) {
+				next[p] = n;
+			} else {
+				head[s] = n;
+			}
+			if (n != NO_VALUE) {
+				prev[n] = p;
+			}
+			owner_array()[element] = NO_SET;
+			--size_array()[s];
+		}
+};
+
+template <typename T>
+const uint32_t fast_set_family<T>::NO_SET;
+
+template <typename T>
+const uint32_t fast_set_family<T>::NO_VALUE;
+
+#endif //_FAST_SET_FAMILY_INCLUDED_
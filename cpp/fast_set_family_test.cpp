@@ -0,0 +1,122 @@
+// fast_set_family_test.cpp
+
+// build: g++ -std=c++14 -O2 fast_set_family_test.cpp -o fast_set_family_test
+
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "fast_set_family.h"
+#include "superkiss64.h"
+
+typedef fast_set_family<uint16_t> family_type;
+
+// whether the family holds exactly the sets of reference, reference[e] being the set of e or NO_SET:
+// owner(), contains(), size() and the enumeration of each set, plain and through the view
+int check_against(const family_type& f, const std::vector<uint32_t>& reference)
+{
+	int failures = 0;
+	std::vector<std::set<uint16_t>> expected(f.num_sets());
+	for (size_t e = 0; e < reference.size(); ++e) {
+		failures += f.owner(uint16_t(e)) != reference[e];
+		if (reference[e] != family_type::NO_SET) {
+			expected[reference[e]].insert(uint16_t(e));
+		}
+	}
+	for (uint64_t s = 0; s < f.num_sets(); ++s) {
+		std::multiset<uint16_t> listed(f.cbegin(s), f.cend(s));
+		std::multiset<uint16_t> viewed(f[s].begin(), f[s].end());
+		failures += listed != std::multiset<uint16_t>(expected[s].begin(), expected[s].end()) || viewed != listed;
+		failures += f.size(s) != expected[s].size() || f[s].size() != expected[s].size();
+		failures += f.is_empty(s) != expected[s].empty();
+		for (size_t e = 0; e < reference.size(); ++e) {
+			failures += f.contains(s, uint16_t(e)) != (reference[e] == s) || f[s].contains(uint16_t(e)) != (reference[e] == s);
+		}
+	}
+	return failures;
+}
+
+// the basic moves, step by step
+int check_moves()
+{
+	int failures = 0;
+	family_type f(3, 10);
+	std::vector<uint32_t> reference(10, family_type::NO_SET);
+	failures += check_against(f, reference);
+
+	failures += !f.insert(0, 4);
+	failures += !f.insert(0, 7);
+	failures += f.insert(0, 4);				// already there
+	reference[4] = reference[7] = 0;
+	failures += check_against(f, reference);
+
+	failures += !f.insert(2, 4);			// moves from set 0 to set 2
+	reference[4] = 2;
+	failures += check_against(f, reference);
+
+	failures += f.remove(0, 4);				// not in set 0
+	failures += !f.remove(2, 4);
+	reference[4] = family_type::NO_SET;
+	failures += check_against(f, reference);
+
+	failures += !f.remove(uint16_t(7));		// from whichever set holds it
+	failures += f.remove(uint16_t(7));
+	reference[7] = family_type::NO_SET;
+	failures += check_against(f, reference);
+	return failures;
+}
+
+// random inserts, moves and removals against a reference owner list, growing the family along the way
+int check_random(superkiss64& rng)
+{
+	int failures = 0;
+	const uint16_t N = 200;
+	family_type f(4, N);
+	std::vector<uint32_t> reference(N, family_type::NO_SET);
+	for (int step = 0; step < 5000; ++step) {
+		uint16_t e = uint16_t(rng.rand() % N);
+		uint64_t s = rng.rand() % f.num_sets();
+		switch (rng.rand() % 4) {
+			case 0:
+			case 1:
+				failures += f.insert(s, e) != (reference[e] != s);
+				reference[e] = uint32_t(s);
+				break;
+			case 2:
+				failures += f.remove(s, e) != (reference[e] == s);
+				if (reference[e] == s) {
+					reference[e] = family_type::NO_SET;
+				}
+				break;
+			case 3:
+				failures += f.remove(e) != (reference[e] != family_type::NO_SET);
+				reference[e] = family_type::NO_SET;
+				break;
+		}
+		if (step % 1000 == 999) {
+			// the new sets are empty, and the old ones keep their elements
+			f.grow(f.num_sets() * 2 + 1);
+			family_type copy = f;
+			failures += check_against(copy, reference);
+		}
+		if (step % 100 == 0) {
+			failures += check_against(f, reference);
+		}
+	}
+	failures += check_against(f, reference);
+	failures += f.num_sets() != 159;
+
+	f.grow(10);								// never shrinks
+	failures += f.num_sets() != 159;
+	return failures;
+}
+
+int main()
+{
+	superkiss64 rng;
+	int failures = 0;
+	failures += check_moves();
+	failures += check_random(rng);
+	std::cout << failures << " failures" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -1,5 +1,11 @@
+// fast_set_test.cpp
+
+// build: g++ -std=c++14 -O2 -march=native fast_set_test.cpp -o fast_set_test
+
 #include <iostream>
 #include <random>
+#include <set>
+#include <vector>
 
 #define ordered_iterator_impl
 #include "fast_set.h"
@@ -73,6 +79,101 @@ void show2(const fast_set<uint8_t>& set)
 	std::cout << "}" << std::endl;
 }
 
+// whether set holds exactly the elements of expected
+template <typename T>
+bool agrees(const fast_set<T>& set, const std::set<T>& expected)
+{
+	if (set.size() != expected.size() || std::set<T>(set.cbegin(), set.cend()) != expected) {
+		return false;
+	}
+	for (uint64_t e = 0; e < set.capacity(); ++e) {
+		if (set.contains(T(e)) != (expected.count(T(e)) > 0)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// random batches, with duplicates and of lengths around the 8-lane and 64-bit mask boundaries, against
+// std::set: the counts returned by insert_many, remove_many and contains_many, and every bit of the mask
+template <typename T>
+int check_batch(uint64_t capacity, superkiss64& rng)
+{
+	int failures = 0;
+	fast_set<T> set(capacity);
+	std::set<T> mirror;
+	for (int round = 0; round < 50; ++round) {
+		std::vector<T> inserted(rng.rand() % 150), removed(rng.rand() % 100), probed(rng.rand() % 200);
+		for (auto batch : {&inserted, &removed, &probed}) {
+			for (auto it = batch->begin(); it != batch->end(); ++it) {
+				*it = T(rng.rand() % capacity);
+			}
+		}
+
+		uint64_t expected = 0;
+		for (auto it = inserted.begin(); it != inserted.end(); ++it) {
+			expected += mirror.insert(*it).second;
+		}
+		failures += set.insert_many(inserted) != expected;
+
+		expected = 0;
+		for (auto it = removed.begin(); it != removed.end(); ++it) {
+			expected += mirror.erase(*it);
+		}
+		failures += set.remove_many(removed) != expected;
+		failures += !agrees(set, mirror);
+
+		// the mask words start out all ones: contains_many must write every bit, not only the hits
+		std::vector<uint64_t> mask((probed.size() + 63) / 64, ~uint64_t(0));
+		expected = 0;
+		uint64_t found = set.contains_many(probed, mask);
+		failures += mask.size() != (probed.size() + 63) / 64;
+		for (size_t i = 0; i < probed.size(); ++i) {
+			bool member = mirror.count(probed[i]) > 0;
+			expected += member;
+			failures += ((mask[i / 64] >> (i % 64)) & 1) != uint64_t(member);
+		}
+		for (size_t i = probed.size(); i < 64 * mask.size(); ++i) {
+			failures += ((mask[i / 64] >> (i % 64)) & 1) != 0;
+		}
+		failures += found != expected;
+	}
+	return failures;
+}
+
+// clear() leaves the positions as they are: after it, and after reinserting a few elements, the stale
+// positions of the cleared elements must not make them members again
+int check_clear(superkiss64& rng)
+{
+	int failures = 0;
+	fast_set<uint16_t> set(500);
+	std::set<uint16_t> mirror;
+	for (int round = 0; round < 50; ++round) {
+		for (int i = 0; i < 300; ++i) {
+			set.insert(uint16_t(rng.rand() % 500));
+		}
+		set.clear();
+		mirror.clear();
+		failures += !set.is_empty() || !agrees(set, mirror);
+
+		// the reinserted elements take the first slots of the element list, where stale positions point
+		int num_reinserted = int(rng.rand() % 20);
+		for (int i = 0; i < num_reinserted; ++i) {
+			uint16_t e = uint16_t(rng.rand() % 500);
+			failures += set.insert(e) != mirror.insert(e).second;
+		}
+		failures += !agrees(set, mirror);
+		failures += set.ordered_elements() != std::vector<uint16_t>(mirror.begin(), mirror.end());
+		if (!mirror.empty()) {
+			uint16_t e = *mirror.begin();
+			set.remove(e);
+			mirror.erase(e);
+			failures += !agrees(set, mirror);
+		}
+	}
+	return failures;
+}
+
 int main()
 {
 	std::random_device rd;
@@ -93,5 +194,12 @@ int main()
 	set.insert(25);
 	show2(set);
 
-
+	int failures = 0;
+	failures += check_batch<uint8_t>(200, rng);
+	failures += check_batch<uint16_t>(1000, rng);
+	failures += check_batch<uint32_t>(70, rng);
+	failures += check_batch<uint32_t>(100000, rng);
+	failures += check_clear(rng);
+	std::cout << failures << " failures" << std::endl;
+	return failures == 0 ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+// flat_backtrack.h
+
+/***
+flat_backtrack<ElemType> is the backtrack<ElemType> engine of backtrack.h without heap traffic in the
+search loop.  backtrack keeps one std::stack (a std::deque) of candidates per position, and every push
+may allocate a deque chunk.  Here all the candidates live in one contiguous candidate_buffer, used as
+a single stack with one segment per position, see static_backtrack.h.
+
+The buffer and the solution are reserved once, before the search, from the FlatStrategy's max_depth()
+and max_branching(): at most max_branching() candidates for each of max_depth() positions.  Nothing is
+allocated afterwards (if a strategy pushes more than it announced, the buffer still grows, correctly).
+
+Candidates are taken last pushed first, as from backtrack's stacks, so a strategy ported from Strategy
+to FlatStrategy (push into the buffer instead of stacks[partial_soln.size()]) visits the same solutions
+in the same order.  Solutions go to the same Accumulator<ElemType> as backtrack's.
+
+flat_backtrack is static_backtrack instantiated with the virtual FlatStrategy and Accumulator
+interfaces, ie: the adapter that keeps run time polymorphic strategies working.
+***/
+
+#ifndef _FLAT_BACKTRACK_H_INCLUDED
+#define _FLAT_BACKTRACK_H_INCLUDED
+
+#include <vector>
+#include <cstddef>
+
+#include "backtrack.h"
+#include "static_backtrack.h"
+
+template <typename ElemType>
+class FlatStrategy {
+	public:
+		virtual int get_candidates(candidate_buffer<ElemType>& candidates, const std::vector<ElemType>& partial_soln) = 0;
+		// computes the candidates for the next element of partial_soln (partial_soln.size()), and pushes
+		// them into candidates.  Returns the number of candidates computed.
+
+		virtual bool is_solution(const std::vector<ElemType>& soln) const = 0;
+		// returns true of soln is a solution to the problem, false otherwise
+
+		virtual void on_push(const ElemType&) {}
+		// called right after an element is appended to the partial solution, as Strategy::on_push
+
+		virtual void on_pop(const ElemType&) {}
+		// called right after an element is removed from the end of the partial solution, as Strategy::on_pop
+
+		virtual size_t max_depth() const = 0;
+		// an upper bound on the length of partial solutions, used to reserve memory
+
+		virtual size_t max_branching() const = 0;
+		// an upper bound on the number of candidates for one position, used to reserve memory
+
+		virtual ~FlatStrategy() {}
+};
+
+// every call goes through the vtables, so any FlatStrategy/Accumulator pair can be mixed at run time
+template <typename ElemType>
+class flat_backtrack : public static_backtrack<ElemType, FlatStrategy<ElemType>, Accumulator<ElemType>> {
+	public:
+		flat_backtrack(FlatStrategy<ElemType>& strat, Accumulator<ElemType>& accum) :
+			static_backtrack<ElemType, FlatStrategy<ElemType>, Accumulator<ElemType>>(strat, accum)
+		{
+		}
+};
+
+#endif //_FLAT_BACKTRACK_H_INCLUDED
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cassert>
 #include "graph.h"
 #include "fast_set.h"
 
@@ -13,46 +14,97 @@ std::ostream& operator<<(std::ostream& o, const edge_type& e)
 void graph::insert_into_deg_vertex_set(int deg, int v)
 {
 //	std::cout << "inserting vertex: " << v << " of degree " << deg << std::endl;
-	deg_vertex_set[deg].insert(v);
+	if (uint64_t(deg) >= deg_vertex_set.num_sets()) {
+		deg_vertex_set.grow(std::max(uint64_t(deg) + 1, 2 * deg_vertex_set.num_sets()));
+	}
+	if (deg_vertex_set.size(deg) > 0) {
+		++num_collisions;
+	}
+	deg_vertex_set.insert(deg, v);
 }
 
 void graph::remove_from_deg_vertex_set(int deg, int v)
 {
 //	std::cout << "removing vertex: " << v << " of degree " << deg << std::endl;
-	deg_vertex_set[deg].remove(v);
-}
-
-void graph::insert_into_adj_matrix(int a, int b, int edge_index)
-{
-	int v0 = std::min(a,b);
-	int v1 = std::max(a,b);
-	adj_matrix[v0 + v1*(v1-1)/2] = edge_index;
+	deg_vertex_set.remove(deg, v);
+	if (deg_vertex_set.size(deg) > 0) {
+		--num_collisions;
+	}
 }
 
-int graph::get_from_adj_matrix(int a, int b)
+int graph::get_edge_index(int a, int b) const
 {
-	int v0 = std::min(a,b);
-	int v1 = std::max(a,b);
-	return adj_matrix[v0 + v1*(v1-1)/2];
+	if (get_num_incident(b) < get_num_incident(a)) {
+		std::swap(a, b);
+	}
+	auto first = inc_list.begin() + inc_offsets[a];
+	auto last = inc_list.begin() + inc_offsets[a + 1];
+	auto it = std::lower_bound(first, last, b, [this, a](int edge_index, int v) { return get_other_end(edge_index, a) < v; });
+	return it != last && get_other_end(*it, a) == b ? *it : -1;
 }
 
 graph::graph(int n, const edge_list& E) : 
 	num_vertices(n), num_edges(E.size()), edges(E), weights(E.size(), 1), degrees(n, 0), 
-	adj_matrix(n*(n-1)/2, -1), inc_list(n, std::vector<int>()), deg_vertex_set(n*(n-1) + 1, fast_set<uint16_t>(num_vertices)),
-	vertex_priority(num_vertices), edge_priority(num_edges)
+	inc_offsets(n + 1, 0), inc_list(2 * E.size()), deg_vertex_set(1, num_vertices),
+	edge_heap(num_edges, edge_priority_type(0, 0)),
+	num_collisions(0), weight_count(2, 0), max_weight(num_edges > 0 ? 1 : 0)
 {
+	weight_count[1] = num_edges;
+	
+	// CSR incidence lists: count, prefix sum, fill, then order each vertex's edges by their other end
+	for (int edge_index = 0; edge_index < num_edges; ++edge_index) {
+		inc_offsets[edges[edge_index].first + 1] += 1;
+		inc_offsets[edges[edge_index].second + 1] += 1;
+	}
+	for (int v = 0; v < num_vertices; ++v) {
+		inc_offsets[v + 1] += inc_offsets[v];
+	}
+	std::vector<int> fill(inc_offsets.begin(), inc_offsets.end() - 1);
+	for (int edge_index = 0; edge_index < num_edges; ++edge_index) {
+		inc_list[fill[edges[edge_index].first]++] = edge_index;
+		inc_list[fill[edges[edge_index].second]++] = edge_index;
+	}
+	int max_degree = 0;
+	for (int v = 0; v < num_vertices; ++v) {
+		std::sort(inc_list.begin() + inc_offsets[v], inc_list.begin() + inc_offsets[v + 1], [this, v](int e0, int e1) {
+			return std::make_pair(get_other_end(e0, v), e0) < std::make_pair(get_other_end(e1, v), e1);
+		});
+		max_degree = std::max(max_degree, get_num_incident(v));
+	}
+	
 	for (int edge_index = 0; edge_index < num_edges; ++edge_index) {
-		int v0 = edges[edge_index].first;
-		int v1 = edges[edge_index].second;
-		degrees[v0] += weights[edge_index];
-		degrees[v1] += weights[edge_index];
-		inc_list[v0].push_back(edge_index);
-		inc_list[v1].push_back(edge_index);
-		insert_into_adj_matrix(v0,v1,edge_index);
+		degrees[edges[edge_index].first] += weights[edge_index];
+		degrees[edges[edge_index].second] += weights[edge_index];
 	}
+	deg_vertex_set.grow(max_degree + 1);
 	for (int vertex_index = 0; vertex_index < num_vertices; ++vertex_index) {
 		insert_into_deg_vertex_set(degrees[vertex_index], vertex_index);
 	}
+	for (int edge_index = 0; edge_index < num_edges; ++edge_index) {
+		edge_heap.update(edge_index, edge_priority_type(get_edge_priority(edge_index), edge_index));
+	}
+}
+
+int graph::get_lower_bound_on_s_G() const
+{
+	std::vector<int> num_of_degree(num_edges + 1, 0);
+	for (int v = 0; v < num_vertices; ++v) {
+		num_of_degree[get_num_incident(v)] += 1;
+	}
+	// the vertices of degree delta..i need distinct weighted degrees in [delta, i s]
+	int bound = 1;
+	int delta = 0;			// the least degree of a non isolated vertex
+	int num_up_to = 0;		// vertices of degree delta..i
+	for (int i = 1; i <= num_edges; ++i) {
+		if (num_of_degree[i] > 0) {
+			if (delta == 0) {
+				delta = i;
+			}
+			num_up_to += num_of_degree[i];
+			bound = std::max(bound, (num_up_to + delta - 1 + i - 1) / i);
+		}
+	}
+	return bound;
 }
 
 int graph::adjust_weight(int edge_index, int new_weight)
@@ -64,17 +116,15 @@ int graph::adjust_weight(int edge_index, int new_weight)
 	int v0 = edges[edge_index].first;
 	int v1 = edges[edge_index].second;
 	
-	{
-		int dv0 = degrees[v0];
-		int dv1 = degrees[v1];
-		
-		remove_from_deg_vertex_set(dv0, v0);
-		remove_from_deg_vertex_set(dv1, v1);
-	}
+	int old_dv0 = degrees[v0];
+	int old_dv1 = degrees[v1];
+	remove_from_deg_vertex_set(old_dv0, v0);
+	remove_from_deg_vertex_set(old_dv1, v1);
 	degrees[v0] += (new_weight - old_weight);
 	degrees[v1] += (new_weight - old_weight);
 	
 	weights[edge_index] = new_weight;
+	adjust_weight_count(old_weight, new_weight);
 	
 	{
 		int dv0 = degrees[v0];
@@ -84,25 +134,57 @@ int graph::adjust_weight(int edge_index, int new_weight)
 		insert_into_deg_vertex_set(dv1, v1);
 	}
 	
+	// only the vertices of the (at most 4) degree classes v0 and v1 left or joined changed priority
+	const int changed[4] = {old_dv0, old_dv1, degrees[v0], degrees[v1]};
+	for (int i = 0; i < 4; ++i) {
+		if (std::find(changed, changed + i, changed[i]) == changed + i) {
+			update_edge_priorities(changed[i]);
+		}
+	}
+	
 	return old_weight;
 }
 
-int graph::compute_edge_priorities()
+// moves an edge from weight old_weight to new_weight in the histogram, and keeps max_weight, which
+// only needs a scan when the last edge of the greatest weight gets lighter
+void graph::adjust_weight_count(int old_weight, int new_weight)
 {
-	for (int i = 0; i < deg_vertex_set.size(); ++i) {
-		for (int j = 0; j < deg_vertex_set[i].size(); ++j) {
-			vertex_priority[deg_vertex_set[i][j]] = std::pair<int,int>(deg_vertex_set[i].size(), i);
-		}
+	assert(new_weight > 0);
+	if (new_weight >= int(weight_count.size())) {
+		weight_count.resize(new_weight + 1, 0);
 	}
-	
-	for (int i = 0; i < num_edges; ++i) {
-		std::pair<int,int> p0 = vertex_priority[edges[i].first];
-		std::pair<int,int> p1 = vertex_priority[edges[i].second];
-		edge_priority[i].first = (p0.second != p1.second ? p1.first * p0.first : 0);
-		edge_priority[i].second = i;
+	--weight_count[old_weight];
+	++weight_count[new_weight];
+	if (new_weight > max_weight) {
+		max_weight = new_weight;
+	}
+	while (weight_count[max_weight] == 0) {
+		--max_weight;
+	}
+}
+
+// (number of vertices of the same degree as v, degree of v)
+std::pair<int,int> graph::get_vertex_priority(int v) const
+{
+	return std::pair<int,int>(deg_vertex_set.size(degrees[v]), degrees[v]);
+}
+
+// the product of the sizes of the degree classes of the ends, 0 when they are in the same class
+int64_t graph::get_edge_priority(int edge_index) const
+{
+	std::pair<int,int> p0 = get_vertex_priority(edges[edge_index].first);
+	std::pair<int,int> p1 = get_vertex_priority(edges[edge_index].second);
+	return p0.second != p1.second ? int64_t(p1.first) * p0.first : 0;
+}
+
+// refreshes the priorities of the edges incident to the vertices of degree deg
+void graph::update_edge_priorities(int deg)
+{
+	for (auto it = deg_vertex_set.cbegin(deg); it != deg_vertex_set.cend(deg); ++it) {
+		for (int i = inc_offsets[*it]; i < inc_offsets[*it + 1]; ++i) {
+			edge_heap.update(inc_list[i], edge_priority_type(get_edge_priority(inc_list[i]), inc_list[i]));
+		}
 	}
-	std::sort(edge_priority.begin(), edge_priority.end(), std::greater<std::pair<int,int>>());
-	return edge_priority[0].second;
 }
 
 std::ostream& graph::display(std::ostream& o)
@@ -116,16 +198,16 @@ std::ostream& graph::display(std::ostream& o)
 		o << "not irregular" << std::endl;
 	}
 	o << "inc list:\n";
-	for (int v = 0; v < inc_list.size(); ++v) {
+	for (int v = 0; v < num_vertices; ++v) {
 		o << "  v=" << v << ": ";
-		for (int ei = 0; ei < inc_list[v].size(); ++ei) {
-			o << "e=" << inc_list[v][ei] << " " << edges[inc_list[v][ei]];
-			if (ei < inc_list[v].size() - 1) o << ", ";
+		for (int ei = inc_offsets[v]; ei < inc_offsets[v + 1]; ++ei) {
+			o << "e=" << inc_list[ei] << " " << edges[inc_list[ei]];
+			if (ei < inc_offsets[v + 1] - 1) o << ", ";
 		}
 		o << std::endl;
 	}
 	o << "degree map:\n";
-	for (int d = 0; d < deg_vertex_set.size(); ++d) {
+	for (uint64_t d = 0; d < deg_vertex_set.num_sets(); ++d) {
 		if (deg_vertex_set[d].size() > 0) {
 			o << "  degree: " << d << ": " << deg_vertex_set[d] << std::endl;
 		}
@@ -133,12 +215,12 @@ std::ostream& graph::display(std::ostream& o)
 	
 	std::vector<std::pair<int,int>> sorted_deg_vertex_set;
 	
-	for (int d = 0; d < deg_vertex_set.size(); ++d) {
+	for (uint64_t d = 0; d < deg_vertex_set.num_sets(); ++d) {
 		sorted_deg_vertex_set.push_back(std::pair<int,int>(deg_vertex_set[d].size(), d));
 	}
 	std::sort(sorted_deg_vertex_set.begin(), sorted_deg_vertex_set.end(), std::greater<std::pair<int,int>>());
 	o << "sorted degree map:\n";
-	for (int d = 0; d < sorted_deg_vertex_set.size(); ++d) {
+	for (size_t d = 0; d < sorted_deg_vertex_set.size(); ++d) {
 		if (sorted_deg_vertex_set[d].first > 0) {
 			o << "  degree: " << sorted_deg_vertex_set[d].second << ": " << deg_vertex_set[sorted_deg_vertex_set[d].second] << std::endl;
 		}
@@ -146,8 +228,13 @@ std::ostream& graph::display(std::ostream& o)
 
 	o << "Vertex Priority: (set size, degree)" << std::endl;
 	for (int i = 0; i < num_vertices; ++i) {
-		o << i << " : " << vertex_priority[i] << std::endl;
+		o << i << " : " << get_vertex_priority(i) << std::endl;
+	}
+	std::vector<edge_priority_type> edge_priority;
+	for (int i = 0; i < num_edges; ++i) {
+		edge_priority.push_back(edge_heap.key(i));
 	}
+	std::sort(edge_priority.begin(), edge_priority.end(), std::greater<edge_priority_type>());
 	o << "Edge Priority:" << std::endl;
 	for (int i = 0; i < num_edges; ++i) {
 		o << edge_priority[i].second << " : " << edges[edge_priority[i].second] << " : " << edge_priority[i].first << std::endl;
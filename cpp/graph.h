@@ -1,18 +1,26 @@
 // graph.h
 
+#ifndef _GRAPH_H_INCLUDED_
+#define _GRAPH_H_INCLUDED_
+
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 
 #include "fast_set.h"
+#include "fast_set_family.h"
+#include "indexed_heap.h"
 
 typedef std::pair<int,int>					edge_type;
 typedef std::vector<edge_type>				edge_list;
 typedef std::vector<int>					weights_list;				// for each edge, weight of the edge
 typedef std::vector<int>					degree_list;				// for each vertex, deg(v)
-typedef std::vector<std::vector<int>>		incidence_list;				// for each vertex, list of incident edge_indices
+typedef std::vector<int>					incidence_list;				// CSR: the incident edge_indices of each vertex, one after the other
+typedef std::vector<int>					incidence_offsets;			// CSR: v's incident edges are [offsets[v], offsets[v+1]) of the incidence_list
 //typedef std::vector<fast_integer_set>		degree_vertex_set;			// for each degree, d, the {v in V(G), with deg(v) = d}
-typedef std::vector<fast_set<uint16_t>>		degree_vertex_set;			// for each degree, d, the {v in V(G), with deg(v) = d}
-typedef std::vector<int>					adjacency_matrix;			// adjacency matrix, compressed to lower triangular, with edge index or -1
+typedef fast_set_family<uint32_t>			degree_vertex_set;			// for each degree, d, the {v in V(G), with deg(v) = d}
+typedef std::pair<int64_t,int>				edge_priority_type;			// (priority, edge index): the product of two class sizes can pass 2^31
+typedef indexed_heap<edge_priority_type>	edge_priority_heap;			// for each edge, (priority, edge index), greatest on top
 
 template <typename T>
 std::ostream& operator<<(std::ostream& o, const fast_set<T>& v)
@@ -25,6 +33,16 @@ std::ostream& operator<<(std::ostream& o, const fast_set<T>& v)
 	return o << "}";
 }
 
+inline std::ostream& operator<<(std::ostream& o, const degree_vertex_set::const_set_view& v)
+{
+	o << "{";
+	for (auto it = v.cbegin(); it != v.cend(); ) {
+		o << (int)*it;
+		if (++it != v.cend()) o << ", ";
+	}
+	return o << "}";
+}
+
 std::ostream& operator<<(std::ostream& o, const edge_type& e);
 
 template <typename T>
@@ -52,12 +70,14 @@ class graph {
 			return num_vertices - 1;
 		}
 		
+		// max over the degrees i of ceil((n_delta + ... + n_i + delta - 1) / i), n_j the number of vertices
+		// of degree j in the unweighted graph, and delta the least degree of a non isolated vertex
+		int get_lower_bound_on_s_G() const;
+		
 		bool is_irregular() const
 		{
 			// if a degree is shared by more than 1 vertex, it is NOT an irregular assignment
-			auto size_gt_1 = [](auto x) { return x.size() > 1; };
-			auto it = std::find_if(deg_vertex_set.begin(), deg_vertex_set.end(), size_gt_1);
-			return it == deg_vertex_set.end();
+			return num_collisions == 0;
 		}
 		
 		int get_weight(int edge_index) const
@@ -65,9 +85,26 @@ class graph {
 			return weights[edge_index];
 		}
 		
+		const weights_list& get_weights() const
+		{
+			return weights;
+		}
+		
+		const edge_list& get_edges() const
+		{
+			return edges;
+		}
+		
 		int adjust_weight(int edge_index, int new_weight);
-		int compute_edge_priorities();
-		int s() const { return *(std::max_element(weights.begin(), weights.end())); }
+		
+		// the index of the edge {v0, v1}, or -1: a binary search among the incident edges of the end
+		// of lower degree, which are sorted by their other end
+		int get_edge_index(int v0, int v1) const;
+		
+		// the edge of highest priority, O(1): the priorities are kept up to date by adjust_weight
+		int compute_edge_priorities() const { return edge_heap.top(); }
+		
+		int s() const { return max_weight; }
 		std::ostream& display(std::ostream& o);
 	
 	private:
@@ -76,20 +113,36 @@ class graph {
 		edge_list			edges;
 		weights_list		weights;
 		degree_list			degrees;
-		incidence_list		inc_list;
-		degree_vertex_set	deg_vertex_set;
-		adjacency_matrix	adj_matrix;
-		std::vector<std::pair<int,int>> vertex_priority;
-		std::vector<std::pair<int,int>> edge_priority;
+		incidence_offsets	inc_offsets;		// n + 1
+		incidence_list		inc_list;			// 2m, in the order of the other ends
+		degree_vertex_set	deg_vertex_set;		// buckets up to the greatest weighted degree, grown on demand
+		edge_priority_heap	edge_heap;
+		int					num_collisions;		// sum over the degree classes of (size - 1), 0 iff irregular
+		std::vector<int>	weight_count;		// for each weight w, the number of edges of weight w
+		int					max_weight;			// the greatest w with weight_count[w] > 0, or 0
 		
 		
 		void insert_into_deg_vertex_set(int deg, int v);
 		void remove_from_deg_vertex_set(int deg, int v);
 		
-		void insert_into_adj_matrix(int v0, int v1, int edge_index);
-		int get_from_adj_matrix(int v0, int v1);
+		int get_other_end(int edge_index, int v) const
+		{
+			return edges[edge_index].first == v ? edges[edge_index].second : edges[edge_index].first;
+		}
+		
+		int get_num_incident(int v) const
+		{
+			return inc_offsets[v + 1] - inc_offsets[v];
+		}
+		
+		void adjust_weight_count(int old_weight, int new_weight);
+		
+		std::pair<int,int> get_vertex_priority(int v) const;
+		int64_t get_edge_priority(int edge_index) const;
+		void update_edge_priorities(int deg);
 		
 		
 
 };
 
+#endif //_GRAPH_H_INCLUDED_
@@ -0,0 +1,91 @@
+// graph_bench.cpp
+
+// build: g++ -std=c++14 -O2 graph_bench.cpp graph.cpp -o graph_bench
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <cstdint>
+
+#include "graph.h"
+#include "graph_fixtures.h"
+#include "superkiss64.h"
+#include "timer.h"
+
+// m distinct random edges over n vertices
+graph sparse(int n, int m, superkiss64& rng)
+{
+	std::vector<uint64_t> keys;
+	while (int(keys.size()) < m) {
+		for (int i = int(keys.size()); i < m; ++i) {
+			uint64_t a = rng.rand() % n, b = rng.rand() % n;
+			if (a != b) {
+				keys.push_back(std::min(a, b) * n + std::max(a, b));
+			}
+		}
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	}
+	edge_list edges;
+	for (auto it = keys.begin(); it != keys.end(); ++it) {
+		edges.push_back(edge_type(int(*it / n), int(*it % n)));
+	}
+	return graph(n, edges);
+}
+
+// the search loop of main.cpp: the termination tests, then a random weight in [1, n-1] for the edge of
+// highest priority.  Reports the time of an iteration.
+void bench_search_loop(const std::string& name, graph g, int iterations, int smax = 0)
+{
+	superkiss64 rng;
+	if (smax == 0) {
+		smax = g.get_ve().first - 1;
+	}
+	int num_irregular = 0;
+	long long sum_s = 0;
+
+	timer t;
+	t.start();
+	for (int i = 0; i < iterations; ++i) {
+		if (g.is_irregular()) {
+			++num_irregular;
+		}
+		sum_s += g.s();
+		int edge_index = g.compute_edge_priorities();
+		int weight = 0;
+		do {
+			weight = (int)(1. + rng.rand01() * smax);
+		} while (weight == g.get_weight(edge_index));
+		g.adjust_weight(edge_index, weight);
+	}
+	double iteration_ns = timer::to_nanoseconds(t.stop()) / iterations;
+
+	std::pair<int,int> ve = g.get_ve();
+	std::cout << std::setw(7) << name << std::setw(8) << ve.first << std::setw(9) << ve.second
+			  << std::setw(16) << iteration_ns
+			  << "   (" << num_irregular << " irregular, s sum " << sum_s << ")" << std::endl;
+}
+
+int main()
+{
+	std::cout << std::setw(7) << "graph" << std::setw(8) << "n" << std::setw(9) << "m"
+			  << std::setw(16) << "iteration ns" << std::endl;
+	for (int n : {100, 300}) {
+		bench_search_loop("star", star(n), 100000);
+		bench_search_loop("K_n", complete(n), 10000);
+	}
+
+	// O(V + E) storage: large sparse graphs, the weights kept small as an irregular assignment needs
+	std::unique_ptr<superkiss64> rng(new superkiss64());
+	for (int m : {100000, 1000000}) {
+		timer t;
+		t.start();
+		graph g = sparse(m / 5, m, *rng);
+		std::cout << "sparse, built in " << timer::to_milliseconds(t.stop()) << " ms" << std::endl;
+		bench_search_loop("sparse", g, 100, 20);
+	}
+	return 0;
+}
@@ -0,0 +1,107 @@
+// graph_fixtures.h
+
+/***
+The graphs the drivers, tests and benchmarks share, with their known irregularity strengths:
+
+star(n)			: K_1,n-1, vertex 0 joined to the n-1 others, s = n-1 for n >= 3
+complete(n)		: K_n, s = 3 for n >= 3
+h_copies(k)		: Hxkp1, k copies of H (C_4 with a diagonal (a,b)), each joined to a new vertex 0 by
+				  (a,0) and (b,0), s = k+1.  main.cpp searches Hx4p1, h_copies(4).
+path(n)			: P_n, the path on n vertices
+tree(parents)	: the tree where vertex v > 0 is joined to parents[v-1] < v
+
+For the graphs without a closed form, reference_s(g, max_s) finds s(G) by trying every weighting in
+[1,s]^m for s = 1, 2, ...: only for a handful of edges.
+***/
+
+#ifndef _GRAPH_FIXTURES_H_INCLUDED_
+#define _GRAPH_FIXTURES_H_INCLUDED_
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+#include "graph.h"
+
+inline graph star(int n)
+{
+	edge_list edges;
+	for (int v = 1; v < n; ++v) {
+		edges.push_back(edge_type(0, v));
+	}
+	return graph(n, edges);
+}
+
+inline graph complete(int n)
+{
+	edge_list edges;
+	for (int a = 0; a < n; ++a) {
+		for (int b = a + 1; b < n; ++b) {
+			edges.push_back(edge_type(a, b));
+		}
+	}
+	return graph(n, edges);
+}
+
+// copy i of H is C_4 {a,c,b,d} on the vertices 4i+1..4i+4, a = 4i+1 and b = 4i+4
+inline graph h_copies(int k)
+{
+	edge_list edges;
+	for (int i = 0; i < k; ++i) {
+		int a = 4 * i + 1, c = a + 1, d = a + 2, b = a + 3;
+		edges.insert(edges.end(), {{a,c}, {a,d}, {a,b}, {c,b}, {d,b}, {0,a}, {0,b}});
+	}
+	return graph(4 * k + 1, edges);
+}
+
+inline graph path(int n)
+{
+	edge_list edges;
+	for (int v = 1; v < n; ++v) {
+		edges.push_back(edge_type(v - 1, v));
+	}
+	return graph(n, edges);
+}
+
+inline graph tree(const std::vector<int>& parents)
+{
+	edge_list edges;
+	for (int v = 1; v <= int(parents.size()); ++v) {
+		assert(parents[v - 1] < v);
+		edges.push_back(edge_type(parents[v - 1], v));
+	}
+	return graph(int(parents.size()) + 1, edges);
+}
+
+// s(G) by exhaustive search up to max_s, 0 if no weighting in [1,max_s] is irregular
+inline int reference_s(const graph& g, int max_s)
+{
+	const edge_list& edges = g.get_edges();
+	int n = g.get_ve().first;
+	for (int s = 1; s <= max_s; ++s) {
+		std::vector<int> weights(edges.size(), 1);
+		for (;;) {
+			std::vector<int> degrees(n, 0);
+			for (size_t e = 0; e < edges.size(); ++e) {
+				degrees[edges[e].first] += weights[e];
+				degrees[edges[e].second] += weights[e];
+			}
+			std::sort(degrees.begin(), degrees.end());
+			if (std::adjacent_find(degrees.begin(), degrees.end()) == degrees.end()) {
+				return s;
+			}
+			// the next weighting, an odometer over [1,s]^m
+			size_t e = 0;
+			while (e < weights.size() && weights[e] == s) {
+				weights[e++] = 1;
+			}
+			if (e == weights.size()) {
+				break;
+			}
+			weights[e] += 1;
+		}
+	}
+	return 0;
+}
+
+#endif //_GRAPH_FIXTURES_H_INCLUDED_
@@ -0,0 +1,143 @@
+// graph_test.cpp
+
+// build: g++ -std=c++14 -O2 graph_test.cpp graph.cpp -o graph_test
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+#include "graph.h"
+#include "graph_fixtures.h"
+
+// the edge of highest priority, recomputed from scratch as graph used to, from the weights alone
+int reference_top_edge(int n, const edge_list& edges, const weights_list& weights)
+{
+	std::vector<int> degrees(n, 0);
+	for (size_t e = 0; e < edges.size(); ++e) {
+		degrees[edges[e].first] += weights[e];
+		degrees[edges[e].second] += weights[e];
+	}
+	std::map<int,int> class_size;
+	for (int v = 0; v < n; ++v) {
+		class_size[degrees[v]] += 1;
+	}
+	std::pair<int64_t,int> best(-1, -1);
+	for (size_t e = 0; e < edges.size(); ++e) {
+		int d0 = degrees[edges[e].first];
+		int d1 = degrees[edges[e].second];
+		best = std::max(best, std::pair<int64_t,int>(d0 != d1 ? int64_t(class_size[d0]) * class_size[d1] : 0, int(e)));
+	}
+	return best.second;
+}
+
+// whether the weighted degrees are all distinct, recomputed from the weights
+bool reference_is_irregular(int n, const edge_list& edges, const weights_list& weights)
+{
+	std::vector<int> degrees(n, 0);
+	for (size_t e = 0; e < edges.size(); ++e) {
+		degrees[edges[e].first] += weights[e];
+		degrees[edges[e].second] += weights[e];
+	}
+	std::sort(degrees.begin(), degrees.end());
+	return std::adjacent_find(degrees.begin(), degrees.end()) == degrees.end();
+}
+
+// random graphs and weight changes: the edge lookup finds every edge and no other, and the incrementally
+// maintained top edge, irregularity and s(G) are the recomputed ones
+int check_graph_incremental(int num_graphs, std::mt19937& rng)
+{
+	int failures = 0;
+	for (int t = 0; t < num_graphs; ++t) {
+		int n = 3 + rng() % 14;
+		edge_list edges;
+		for (int a = 0; a < n; ++a) {
+			for (int b = a + 1; b < n; ++b) {
+				if (rng() % 3 == 0) {
+					edges.push_back(edge_type(a, b));
+				}
+			}
+		}
+		if (edges.empty()) {
+			continue;
+		}
+		graph g(n, edges);
+		std::vector<int> index(n * n, -1);
+		for (size_t e = 0; e < edges.size(); ++e) {
+			index[edges[e].first * n + edges[e].second] = index[edges[e].second * n + edges[e].first] = int(e);
+		}
+		for (int a = 0; a < n; ++a) {
+			for (int b = 0; b < n; ++b) {
+				failures += g.get_edge_index(a, b) != index[a * n + b];
+			}
+		}
+		for (int u = 0; u < 200; ++u) {
+			const weights_list& weights = g.get_weights();
+			failures += g.compute_edge_priorities() != reference_top_edge(n, edges, weights);
+			failures += g.is_irregular() != reference_is_irregular(n, edges, weights);
+			failures += g.s() != *std::max_element(weights.begin(), weights.end());
+			g.adjust_weight(rng() % edges.size(), 1 + rng() % (u < 100 ? 3 : n));
+		}
+	}
+	return failures;
+}
+
+// 32767 disjoint P4 paths and a K_1,3: degree classes of 65537 and 65534 vertices, whose product passes
+// 2^31 (in an int it would wrap negative, below the priority of the star's edges), and then of 100000
+int check_large_classes()
+{
+	int failures = 0;
+	for (int num_paths : {32767, 50000}) {
+		edge_list edges;
+		for (int p = 0; p < num_paths; ++p) {
+			int v = 4 * p;
+			edges.insert(edges.end(), {{v, v + 1}, {v + 1, v + 2}, {v + 2, v + 3}});
+		}
+		int center = 4 * num_paths;
+		edges.insert(edges.end(), {{center, center + 1}, {center, center + 2}, {center, center + 3}});
+		graph g(center + 4, edges);
+		for (int u = 0; u < 3; ++u) {
+			failures += g.compute_edge_priorities() != reference_top_edge(center + 4, edges, g.get_weights());
+			g.adjust_weight(3 * u + 1, 2);
+		}
+	}
+	return failures;
+}
+
+// the lower bound on s(G) never passes s(G): paths, trees of mixed degrees and the other fixtures
+int check_lower_bound()
+{
+	int failures = 0;
+	std::vector<graph> graphs;
+	for (int n = 3; n <= 8; ++n) {
+		graphs.push_back(path(n));
+	}
+	for (const std::vector<int>& parents : std::vector<std::vector<int>>{
+			{0, 0, 1, 1}, {0, 1, 1, 2, 2}, {0, 0, 0, 1, 2}, {0, 1, 2, 2, 2, 3}, {0, 0, 1, 1, 2, 2}, {0, 1, 1, 1, 4, 4}}) {
+		graphs.push_back(tree(parents));
+	}
+	graphs.push_back(star(5));
+	graphs.push_back(complete(4));
+	graphs.push_back(h_copies(1));
+	for (auto it = graphs.begin(); it != graphs.end(); ++it) {
+		int bound = it->get_lower_bound_on_s_G();
+		int s = reference_s(*it, 6);
+		failures += s == 0 || bound > s;
+	}
+	// s(P_4) = 2: weights 1,2,2 give the degrees 1,3,4,2
+	failures += path(4).get_lower_bound_on_s_G() != 2;
+	return failures;
+}
+
+int main()
+{
+	std::mt19937 rng(12345);
+	int failures = 0;
+	failures += check_graph_incremental(100, rng);
+	failures += check_large_classes();
+	failures += check_lower_bound();
+	std::cout << failures << " failures" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
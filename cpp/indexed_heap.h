@@ -0,0 +1,128 @@
+// indexed_heap.h
+
+/***
+indexed_heap<K, Compare>(N, k) is a binary max-heap (with respect to Compare, std::less by default)
+over the fixed set of items [0,N), each carrying a key of type K, all starting with key k.  Next to the
+heap array, positions[i] is the slot of item i in the heap, so an item can be found and its key changed
+in place.  Let H = indexed_heap<K>(N):
+
+O(1) top(), the item of greatest key, and top_key()
+O(1) key(i)
+O(log N) update(i, k): sets the key of item i, and sifts it up or down
+O(N) storage: N keys, N heap slots and N positions
+
+Items with equal keys come out of top() in no particular order; when the order of ties matters, make it
+part of the key (eg: std::pair<priority, item>).
+***/
+
+#ifndef _INDEXED_HEAP_H_INCLUDED_
+#define _INDEXED_HEAP_H_INCLUDED_
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cassert>
+
+template <typename KeyType, typename Compare = std::less<KeyType>>
+class indexed_heap {
+	public:
+		indexed_heap(size_t n = 0, const KeyType& initial = KeyType(), const Compare& cmp = Compare()) :
+			keys(n, initial),
+			heap(n),
+			positions(n),
+			less(cmp)
+		{
+			for (size_t i = 0; i < n; ++i) {
+				heap[i] = i;
+				positions[i] = i;
+			}
+		}
+
+		size_t size() const
+		{
+			return heap.size();
+		}
+
+		bool empty() const
+		{
+			return heap.empty();
+		}
+
+		size_t top() const
+		{
+			assert(!heap.empty());
+			return heap[0];
+		}
+
+		const KeyType& top_key() const
+		{
+			return keys[top()];
+		}
+
+		const KeyType& key(size_t item) const
+		{
+			assert(item < keys.size());
+			return keys[item];
+		}
+
+		void update(size_t item, const KeyType& k)
+		{
+			assert(item < keys.size());
+			if (less(keys[item], k)) {
+				keys[item] = k;
+				sift_up(positions[item]);
+			} else if (less(k, keys[item])) {
+				keys[item] = k;
+				sift_down(positions[item]);
+			}
+		}
+
+	private:
+		std::vector<KeyType>	keys;			// indexed by item
+		std::vector<size_t>		heap;			// items, heap ordered by key
+		std::vector<size_t>		positions;		// indexed by item, heap[positions[i]] == i
+		Compare					less;
+
+		void place(size_t slot, size_t item)
+		{
+			heap[slot] = item;
+			positions[item] = slot;
+		}
+
+		void sift_up(size_t slot)
+		{
+			size_t item = heap[slot];
+			while (slot > 0) {
+				size_t parent = (slot - 1) / 2;
+				if (!less(keys[heap[parent]], keys[item])) {
+					break;
+				}
+				place(slot, heap[parent]);
+				slot = parent;
+			}
+			place(slot, item);
+		}
+
+		void sift_down(size_t slot)
+		{
+			size_t item = heap[slot];
+			size_t n = heap.size();
+			for (;;) {
+				size_t child = 2 * slot + 1;
+				if (child >= n) {
+					break;
+				}
+				if (child + 1 < n && less(keys[heap[child]], keys[heap[child + 1]])) {
+					++child;
+				}
+				if (!less(keys[item], keys[heap[child]])) {
+					break;
+				}
+				place(slot, heap[child]);
+				slot = child;
+			}
+			place(slot, item);
+		}
+};
+
+#endif //_INDEXED_HEAP_H_INCLUDED_
@@ -0,0 +1,38 @@
+// indexed_heap_test.cpp
+
+// build: g++ -std=c++14 -O2 indexed_heap_test.cpp -o indexed_heap_test
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <utility>
+
+#include "indexed_heap.h"
+
+// random key updates, checked after each against a scan of all the keys
+int check_heap(size_t n, int num_updates, std::mt19937& rng)
+{
+	int failures = 0;
+	indexed_heap<std::pair<int,int>> heap(n, std::pair<int,int>(0, 0));
+	std::vector<std::pair<int,int>> keys(n, std::pair<int,int>(0, 0));
+	for (int u = 0; u < num_updates; ++u) {
+		size_t item = rng() % n;
+		keys[item] = std::pair<int,int>(rng() % 20, int(item));
+		heap.update(item, keys[item]);
+		size_t best = std::max_element(keys.begin(), keys.end()) - keys.begin();
+		failures += heap.top() != best || heap.top_key() != keys[best] || heap.key(item) != keys[item];
+	}
+	return failures;
+}
+
+int main()
+{
+	std::mt19937 rng(12345);
+	int failures = 0;
+	failures += check_heap(1, 10, rng);
+	failures += check_heap(2, 100, rng);
+	failures += check_heap(37, 5000, rng);
+	std::cout << failures << " failures" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+// irregularity_search.cpp
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <climits>
+
+#include "irregularity_search.h"
+#include "superkiss64.h"
+#include "thread_pool.h"
+
+namespace {
+
+enum class trial_outcome { irregular, aborted, pruned, skipped };
+
+// splitmix64, to spread (seed, trial) over the generator state
+uint64_t mix(uint64_t x)
+{
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+// the state shared by the trials of one search
+struct shared_search {
+	std::atomic<int>		smax;			// largest weight a trial may still use
+	std::atomic<bool>		stop;			// optimum found, or out of time
+	int						lower_bound;
+	clock_type::time_point	deadline;
+	bool					timed;
+
+	std::mutex				best_mutex;		// guards best_s and best_weights
+	int						best_s;
+	weights_list			best_weights;
+
+	bool out_of_time() const
+	{
+		return timed && clock_type::now() >= deadline;
+	}
+
+	// records an irregular assignment, and lowers smax below it when it is the best so far
+	void found(const graph& g)
+	{
+		int s = g.s();
+		std::lock_guard<std::mutex> lock(best_mutex);
+		if (s < best_s) {
+			best_s = s;
+			best_weights = g.get_weights();
+			int bound = smax.load();
+			while (bound > s - 1 && !smax.compare_exchange_weak(bound, s - 1)) {
+			}
+			if (s - 1 < lower_bound) {
+				stop = true;
+			}
+		}
+	}
+};
+
+trial_outcome run_trial(const graph& prototype, int trial, const irregularity_search_options& options, shared_search& shared)
+{
+	if (shared.stop || shared.out_of_time()) {
+		return trial_outcome::skipped;
+	}
+
+	// superkiss64 carries 160KB of state, keep it off the worker's stack
+	uint64_t stream = mix(options.seed ^ mix(uint64_t(trial)));
+	std::unique_ptr<superkiss64> rng(new superkiss64(mix(stream) | 1, mix(stream + 1), mix(stream + 2) & 0x1FFFFFFFFFFULL));
+
+	graph g = prototype;
+	for (int iterations = 0; ; ++iterations) {
+		if (shared.stop || shared.out_of_time()) {
+			shared.stop = true;
+			return trial_outcome::skipped;
+		}
+		int smax = shared.smax.load(std::memory_order_relaxed);
+		if (g.s() > smax) {
+			return trial_outcome::pruned;
+		}
+		if (g.is_irregular()) {
+			shared.found(g);
+			return trial_outcome::irregular;
+		}
+		if (iterations >= options.max_iterations || smax < 2) {
+			return trial_outcome::aborted;
+		}
+
+		int edge_index = g.compute_edge_priorities();
+		int weight = 0;
+		do {
+			weight = (int)(1. + rng->rand01() * smax);
+		} while (weight == g.get_weight(edge_index));
+		g.adjust_weight(edge_index, weight);
+	}
+}
+
+}
+
+irregularity_search_result irregularity_search(const graph& g, const irregularity_search_options& options)
+{
+	timer t;
+	t.start();
+
+	shared_search shared;
+	shared.smax = options.smax > 0 ? options.smax : g.get_upper_bound_on_s_G();
+	shared.stop = false;
+	shared.lower_bound = g.get_lower_bound_on_s_G();
+	shared.timed = options.max_time != timer::duration::max();
+	shared.deadline = shared.timed ? clock_type::now() + std::chrono::duration_cast<clock_type::duration>(options.max_time) : clock_type::time_point();
+	shared.best_s = INT_MAX;
+
+	std::vector<trial_outcome> outcomes(options.num_trials, trial_outcome::skipped);
+	{
+		work_stealing_pool pool(options.num_threads);
+		for (int trial = 0; trial < options.num_trials; ++trial) {
+			pool.submit([&g, &options, &shared, &outcomes, trial](size_t) {
+				outcomes[trial] = run_trial(g, trial, options, shared);
+			});
+		}
+		pool.wait();
+	}
+
+	irregularity_search_result result;
+	if (shared.best_s != INT_MAX) {
+		result.best_s = shared.best_s;
+		result.best_weights = shared.best_weights;
+	}
+	result.lower_bound = shared.lower_bound;
+	for (auto it = outcomes.begin(); it != outcomes.end(); ++it) {
+		result.num_irregular += *it == trial_outcome::irregular;
+		result.num_aborted += *it == trial_outcome::aborted;
+		result.num_pruned += *it == trial_outcome::pruned;
+		result.num_skipped += *it == trial_outcome::skipped;
+	}
+	result.elapsed = t.stop();
+	return result;
+}
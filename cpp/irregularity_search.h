@@ -0,0 +1,57 @@
+// irregularity_search.h
+
+/***
+irregularity_search(g, options) runs independent randomized trials of the edge reweighting search for
+an irregular assignment of g (every vertex gets a distinct weighted degree), with the smallest largest
+weight s(G) it can find.
+
+A trial starts from a copy of g with all the weights 1 and, until the assignment is irregular or it
+runs out of iterations, picks the edge of highest priority (compute_edge_priorities) and gives it a
+random weight in [1, smax], different from its current one.
+
+	trials	: run concurrently on a work_stealing_pool, one task per trial.  Trial t draws its weights
+			  from its own superkiss64 stream, seeded from (options.seed, t), so a trial's course does
+			  not depend on the scheduling, only on smax.
+	smax	: shared by all the trials, atomically.  It starts at options.smax (0: the upper bound on
+			  s(G)), and when a trial finds an irregular assignment of s(G) = s, it drops to s - 1: from
+			  then on every trial only looks for a better assignment, and a trial holding a weight above
+			  smax is pruned on its next iteration.  Once smax is below the lower bound on s(G), the best
+			  assignment is optimal and the remaining trials stop.
+	budget	: with options.max_time, trials not finished by then stop, and trials not started are
+			  skipped.
+
+Trials are independent and only share smax, so the search scales with the number of workers.
+***/
+
+#ifndef _IRREGULARITY_SEARCH_H_INCLUDED_
+#define _IRREGULARITY_SEARCH_H_INCLUDED_
+
+#include <cstdint>
+#include <cstddef>
+
+#include "graph.h"
+#include "timer.h"
+
+struct irregularity_search_options {
+	int					num_trials = 100;
+	int					max_iterations = 100;					// per trial
+	int					smax = 0;								// largest weight to start with, 0: the upper bound on s(G)
+	size_t				num_threads = 0;						// 0: one per hardware thread
+	timer::duration		max_time = timer::duration::max();		// wall clock budget
+	uint64_t			seed = 0;
+};
+
+struct irregularity_search_result {
+	int					best_s = 0;				// s(G) of the best irregular assignment, 0 if none was found
+	weights_list		best_weights;			// for each edge, its weight in that assignment
+	int					lower_bound = 0;		// on s(G), best_s == lower_bound means best_s is optimal
+	int					num_irregular = 0;		// trials which found an irregular assignment
+	int					num_aborted = 0;		// trials which ran out of iterations
+	int					num_pruned = 0;			// trials overtaken by a better assignment
+	int					num_skipped = 0;		// trials stopped or not started: optimum found, or out of time
+	timer::duration		elapsed = timer::duration(0);
+};
+
+irregularity_search_result irregularity_search(const graph& g, const irregularity_search_options& options);
+
+#endif //_IRREGULARITY_SEARCH_H_INCLUDED_
@@ -0,0 +1,300 @@
+// irregularity_solver.cpp
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <limits>
+#include <functional>
+
+#include "irregularity_solver.h"
+#include "backtrack.h"
+#include "fast_set.h"
+
+namespace {
+
+// the twin classes of the graph, as chains in vertex index order: pred[v] and succ[v] are the previous
+// and next twins of v, or -1
+void find_twins(int n, const edge_list& edges, std::vector<int>& pred, std::vector<int>& succ)
+{
+	std::vector<std::vector<int>> open(n), closed(n);
+	for (auto it = edges.begin(); it != edges.end(); ++it) {
+		open[it->first].push_back(it->second);
+		open[it->second].push_back(it->first);
+	}
+	for (int v = 0; v < n; ++v) {
+		std::sort(open[v].begin(), open[v].end());
+		closed[v] = open[v];
+		closed[v].insert(std::lower_bound(closed[v].begin(), closed[v].end(), v), v);
+	}
+
+	// a vertex with an open twin has no closed twin, and conversely, so the chains do not overlap
+	pred.assign(n, -1);
+	succ.assign(n, -1);
+	for (const std::vector<std::vector<int>>* neighbourhoods : {&open, &closed}) {
+		std::map<std::vector<int>, int> last;		// the last vertex seen with a neighbourhood
+		for (int v = 0; v < n; ++v) {
+			auto it = last.find((*neighbourhoods)[v]);
+			if (it == last.end()) {
+				last.emplace((*neighbourhoods)[v], v);
+			} else {
+				pred[v] = it->second;
+				succ[it->second] = v;
+				it->second = v;
+			}
+		}
+	}
+}
+
+// the edges of weight 1..s, assigned in order: a weight is a candidate for the next edge if the vertices
+// can still all get distinct final degrees, increasing along the twin chains of its ends
+class irregular_weighting : public Strategy<int> {
+	public:
+		irregular_weighting(int n, const edge_list& ordered_edges, const std::vector<int>& twin_pred, const std::vector<int>& twin_succ,
+							int s, int max_degree) :
+			edges(ordered_edges),
+			pred(twin_pred),
+			succ(twin_succ),
+			smax(s),
+			sum(n, 0),
+			remaining(n, 0),
+			finished(uint32_t(max_degree * s + 1)),
+			depth(0)
+		{
+			for (auto it = edges.begin(); it != edges.end(); ++it) {
+				remaining[it->first] += 1;
+				remaining[it->second] += 1;
+			}
+		}
+
+		int get_candidates(std::vector<std::stack<int>>& stacks, const std::vector<int>& partial_soln)
+		{
+			// pushed heaviest first, so that the lightest comes out first
+			size_t e = partial_soln.size();
+			for (int w = smax; w >= 1; --w) {
+				if (is_feasible(edges[e], w)) {
+					stacks[e].push(w);
+				}
+			}
+			return stacks[e].size();
+		}
+
+		bool is_solution(const std::vector<int>& soln) const
+		{
+			return soln.size() == edges.size();
+		}
+
+		void on_push(const int& w)
+		{
+			const edge_type& e = edges[depth++];
+			add(e.first, w);
+			add(e.second, w);
+		}
+
+		void on_pop(const int& w)
+		{
+			const edge_type& e = edges[--depth];
+			remove(e.second, w);
+			remove(e.first, w);
+		}
+
+	private:
+		const edge_list&			edges;
+		const std::vector<int>&		pred;
+		const std::vector<int>&		succ;
+		int							smax;
+		std::vector<int>			sum;			// for each vertex, the weights of its assigned edges
+		std::vector<int>			remaining;		// for each vertex, the number of its unassigned edges
+		fast_set<uint32_t>			finished;		// the final degrees of the vertices without unassigned edges
+		size_t						depth;			// the number of assigned edges
+		std::vector<std::pair<int,int>>	ranges;			// scratch for is_matchable
+		std::vector<int>			ends;
+
+		void add(int v, int w)
+		{
+			sum[v] += w;
+			if (--remaining[v] == 0) {
+				finished.insert(sum[v]);
+			}
+		}
+
+		void remove(int v, int w)
+		{
+			if (remaining[v]++ == 0) {
+				finished.remove(sum[v]);
+			}
+			sum[v] -= w;
+		}
+
+		// the range of final degrees v can still reach, with weight w on the edge e being considered
+		std::pair<int,int> degree_range(int v, const edge_type& e, int w) const
+		{
+			int p = sum[v];
+			int r = remaining[v];
+			if (v == e.first || v == e.second) {
+				p += w;
+				r -= 1;
+			}
+			return std::pair<int,int>(p + r, p + r * smax);
+		}
+
+		// whether the twins of the end v of e can still get final degrees in increasing order
+		bool is_ordered(int v, const edge_type& e, int w) const
+		{
+			std::pair<int,int> range = degree_range(v, e, w);
+			if (pred[v] >= 0 && degree_range(pred[v], e, w).first >= range.second) {
+				return false;
+			}
+			if (succ[v] >= 0 && degree_range(succ[v], e, w).second <= range.first) {
+				return false;
+			}
+			return true;
+		}
+
+		// whether the unfinished vertices can still get distinct final degrees, that no finished vertex
+		// has: a matching of their degree ranges into the free degrees, found greedily, each free degree in
+		// increasing order going to the range that ends first
+		bool is_matchable(const edge_type& e, int w)
+		{
+			ranges.clear();
+			for (int v = 0; v < int(sum.size()); ++v) {
+				if (remaining[v] > 0) {
+					ranges.push_back(degree_range(v, e, w));
+				}
+			}
+			std::sort(ranges.begin(), ranges.end());
+			ends.clear();
+			size_t next = 0;
+			int d = 0;
+			while (next < ranges.size() || !ends.empty()) {
+				if (ends.empty()) {
+					d = std::max(d, ranges[next].first);
+				}
+				while (next < ranges.size() && ranges[next].first <= d) {
+					ends.push_back(ranges[next++].second);
+					std::push_heap(ends.begin(), ends.end(), std::greater<int>());
+				}
+				if (ends.front() < d) {
+					return false;
+				}
+				if (!finished.contains(d)) {
+					std::pop_heap(ends.begin(), ends.end(), std::greater<int>());
+					ends.pop_back();
+				}
+				++d;
+			}
+			return true;
+		}
+
+		bool is_feasible(const edge_type& e, int w)
+		{
+			return is_ordered(e.first, e, w) && is_ordered(e.second, e, w) && is_matchable(e, w);
+		}
+};
+
+// keeps the first assignment found, and stops the search
+class first_assignment : public Accumulator<int> {
+	public:
+		void operator()(const std::vector<int>& soln)
+		{
+			weights = soln;
+		}
+
+		search_control accumulate(const std::vector<int>& soln)
+		{
+			(*this)(soln);
+			return search_control::stop;
+		}
+
+		std::vector<int> weights;
+};
+
+}
+
+irregularity_solver_result solve_irregularity_strength(const graph& g, const irregularity_solver_options& options)
+{
+	timer t;
+	t.start();
+
+	irregularity_solver_result result;
+	int n = g.get_ve().first;
+	int m = g.get_ve().second;
+	const edge_list& edges = g.get_edges();
+	result.lower_bound = std::max(1, g.get_lower_bound_on_s_G());
+	if (m == 0) {
+		result.elapsed = t.stop();
+		return result;
+	}
+
+	// vertices by increasing degree, and the edges grouped by their later end in that order, so that a
+	// vertex is finished by the group of its last neighbour: the vertices of small degree, with the
+	// narrowest degree ranges, are fixed first
+	std::vector<int> degree(n, 0);
+	for (auto it = edges.begin(); it != edges.end(); ++it) {
+		degree[it->first] += 1;
+		degree[it->second] += 1;
+	}
+	if (std::count(degree.begin(), degree.end(), 0) > 1) {
+		result.elapsed = t.stop();
+		return result;
+	}
+
+	std::vector<int> order(n), position(n);
+	for (int v = 0; v < n; ++v) {
+		order[v] = v;
+	}
+	std::stable_sort(order.begin(), order.end(), [&degree](int a, int b) { return degree[a] < degree[b]; });
+	for (int i = 0; i < n; ++i) {
+		position[order[i]] = i;
+	}
+	std::vector<int> edge_order(m);
+	for (int e = 0; e < m; ++e) {
+		edge_order[e] = e;
+	}
+	auto key = [&edges, &position](int e) {
+		int a = position[edges[e].first];
+		int b = position[edges[e].second];
+		return std::make_pair(std::max(a, b), std::min(a, b));
+	};
+	std::sort(edge_order.begin(), edge_order.end(), [&key](int e0, int e1) { return key(e0) < key(e1); });
+	edge_list ordered_edges;
+	for (int e = 0; e < m; ++e) {
+		ordered_edges.push_back(edges[edge_order[e]]);
+	}
+
+	std::vector<int> pred, succ;
+	find_twins(n, edges, pred, succ);
+	int max_degree = *std::max_element(degree.begin(), degree.end());
+
+	int max_s = options.max_s > 0 ? options.max_s : n;
+	for (int s = result.lower_bound; s <= max_s; ++s) {
+		irregular_weighting strategy(n, ordered_edges, pred, succ, s, max_degree);
+		first_assignment accumulator;
+		backtrack<int> back(strategy, accumulator, m);
+
+		// what is left of the budget
+		search_limits limits = options.limits;
+		if (limits.max_nodes != std::numeric_limits<uint64_t>::max()) {
+			limits.max_nodes -= std::min(limits.max_nodes, result.nodes);
+		}
+		if (limits.max_time != timer::duration::max()) {
+			limits.max_time = std::max(timer::duration(0), limits.max_time - t.elapsed());
+		}
+		back.set_limits(limits);
+
+		search_outcome outcome = back();
+		result.nodes += back.nodes_visited();
+		if (outcome == search_outcome::stopped) {
+			result.s = s;
+			result.weights.assign(m, 0);
+			for (int e = 0; e < m; ++e) {
+				result.weights[edge_order[e]] = accumulator.weights[e];
+			}
+			break;
+		}
+		if (outcome != search_outcome::complete) {
+			break;
+		}
+	}
+	result.elapsed = t.stop();
+	return result;
+}
@@ -0,0 +1,54 @@
+// irregularity_solver.h
+
+/***
+solve_irregularity_strength(g, options) computes the irregularity strength s(G) exactly: the least s
+such that the edges of g can be weighted from [1, s] with all the weighted degrees distinct.
+
+Iterative deepening on s, from the counting lower bound on s(G) (get_lower_bound_on_s_G: no s below it
+leaves enough distinct weighted degrees) up: for each s, a backtrack<int> search over the edge weights,
+the first irregular assignment found stops it.  Since every smaller s from the bound on was searched to
+exhaustion, that s is s(G).  The vertices are taken by increasing
+degree, and the edges grouped by their later end in that order, so that a vertex gets its final degree
+with the group of its last neighbour, the vertices of narrow degree range first.  A weight is a
+candidate for the next edge only if:
+
+	collisions	: the final degrees of the finished vertices, kept in a fast_set, stay distinct
+	bounds		: a vertex still missing r edges, with degree p so far, can reach any degree in
+				  [p + r, p + r s]; these ranges of the unfinished vertices can still be matched to
+				  distinct degrees that no finished vertex has (greedily, O(V log V + Δ s), Δ the largest
+				  degree)
+	symmetry	: twins, vertices with the same neighbourhood (open: N(u) = N(v), or closed: N[u] = N[v]),
+				  can be swapped by an automorphism, so within a twin class the final degrees are
+				  required to increase with the vertex index; the degree ranges of the twins are
+				  checked against that order
+
+The searches share one budget: options.limits bounds the nodes and the wall clock time of them all.
+When it runs out, s is 0.  So it is for graphs with no irregular assignment (two isolated vertices,
+or a K_2 component), once max_s is passed.
+***/
+
+#ifndef _IRREGULARITY_SOLVER_H_INCLUDED_
+#define _IRREGULARITY_SOLVER_H_INCLUDED_
+
+#include <cstdint>
+
+#include "graph.h"
+#include "search_limits.h"
+#include "timer.h"
+
+struct irregularity_solver_options {
+	int					max_s = 0;				// largest s to try, 0: the number of vertices
+	search_limits		limits;					// for all the searches together
+};
+
+struct irregularity_solver_result {
+	int					s = 0;					// s(G), proven: every smaller s is below the bound or was refuted.  0 if not found within max_s or the limits
+	weights_list		weights;				// for each edge, its weight in an irregular assignment of largest weight s
+	int					lower_bound = 0;		// the s the deepening started from
+	uint64_t			nodes = 0;				// backtrack nodes, over all the s tried
+	timer::duration		elapsed = timer::duration(0);
+};
+
+irregularity_solver_result solve_irregularity_strength(const graph& g, const irregularity_solver_options& options);
+
+#endif //_IRREGULARITY_SOLVER_H_INCLUDED_
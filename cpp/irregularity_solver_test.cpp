@@ -0,0 +1,75 @@
+// irregularity_solver_test.cpp
+
+// build: g++ -std=c++14 -O2 irregularity_solver_test.cpp irregularity_solver.cpp graph.cpp -o irregularity_solver_test
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "irregularity_solver.h"
+#include "graph.h"
+#include "graph_fixtures.h"
+
+// solves g, and checks s against the known s(G) and the assignment against s
+int check(const std::string& name, const graph& g, int expected_s)
+{
+	irregularity_solver_result result = solve_irregularity_strength(g, irregularity_solver_options());
+
+	bool valid = result.s > 0 && result.weights.size() == size_t(g.get_ve().second);
+	if (valid) {
+		graph weighted = g;
+		for (int e = 0; e < int(result.weights.size()); ++e) {
+			weighted.adjust_weight(e, result.weights[e]);
+		}
+		valid = weighted.is_irregular() && weighted.s() == result.s;
+	}
+	int failures = (result.s != expected_s) + !valid;
+
+	std::cout << std::setw(8) << name << std::setw(5) << g.get_ve().first << std::setw(5) << g.get_ve().second
+			  << std::setw(5) << result.lower_bound << std::setw(5) << result.s << std::setw(12) << result.nodes
+			  << std::setw(12) << timer::to_milliseconds(result.elapsed)
+			  << (failures > 0 ? "   FAILED, expected s = " + std::to_string(expected_s) : "") << std::endl;
+	return failures;
+}
+
+int main()
+{
+	std::cout << std::setw(8) << "graph" << std::setw(5) << "n" << std::setw(5) << "m" << std::setw(5) << "lb"
+			  << std::setw(5) << "s" << std::setw(12) << "nodes" << std::setw(12) << "ms" << std::endl;
+	int failures = 0;
+
+	// s(K_1,k) = k: the leaves need distinct weights
+	for (int k : {2, 3, 5, 8, 12, 20}) {
+		failures += check("K_1," + std::to_string(k), star(k + 1), k);
+	}
+	// s(K_n) = 3 for n >= 3
+	for (int n : {3, 4, 5, 6, 7, 8, 9}) {
+		failures += check("K_" + std::to_string(n), complete(n), 3);
+	}
+	// s(Hxkp1) = k + 1, the lower bound
+	for (int k = 1; k <= 8; ++k) {
+		failures += check("Hx" + std::to_string(k) + "p1", h_copies(k), k + 1);
+	}
+
+	// graphs of mixed degrees, where the bound is not always s(G): paths and trees, against the minimum
+	// over all weightings
+	for (int n = 3; n <= 8; ++n) {
+		failures += check("P_" + std::to_string(n), path(n), reference_s(path(n), 6));
+	}
+	int t = 0;
+	for (const std::vector<int>& parents : std::vector<std::vector<int>>{
+			{0, 0, 1, 1}, {0, 1, 1, 2, 2}, {0, 0, 0, 1, 2}, {0, 1, 2, 2, 2, 3}, {0, 0, 1, 1, 2, 2}, {0, 1, 1, 1, 4, 4}}) {
+		failures += check("T_" + std::to_string(t++), tree(parents), reference_s(tree(parents), 6));
+	}
+
+	// the limits: a refutation too large for the budget gives s = 0
+	irregularity_solver_options options;
+	options.limits.max_nodes = 10;
+	failures += solve_irregularity_strength(complete(8), options).s != 0;
+	// no irregular assignment with two isolated vertices
+	failures += solve_irregularity_strength(graph(5, {{0,1}, {1,2}}), irregularity_solver_options()).s != 0;
+
+	std::cout << failures << " failures" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
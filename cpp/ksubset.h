@@ -0,0 +1,499 @@
+// ksubset.h
+
+/***
+Enumerations of the k-subsets (combinations) of {0, ..., N-1}, in four orders:
+
+	ksubset_lexicographic	: {0,1,2}, {0,1,3}, ..., {0,1,N-1}, {0,2,3}, ...
+	ksubset_colex			: {0,1,2}, {0,1,3}, {0,2,3}, {1,2,3}, {0,1,4}, ..., ie: by the largest element
+							  first, so the k-subsets of {0, ..., m-1} come before any k-subset using m
+	ksubset_revolving_door	: minimal change order, every step removes one element and adds another
+	ksubset_gosper			: colex order of a packed word, stepped with Gosper's hack (N < 64)
+
+Each step costs O(1) amortized (O(k) worst case), instead of the 2^N / C(N,k) wasted steps of filtering a
+powerset enumeration.  The subset is held as a sorted list of its k elements, get_listvec(), and the
+vector<bool> view, get_bitvec(), is only materialized when asked for.  As for powerset, changes() lists
+the elements removed and added by the last step: exactly one of each for the revolving door order.
+
+Enumeration visits the first subset on construction, and next() past the last subset sets done():
+
+	for (ksubset_revolving_door ks(N, k); !ks.done(); ks.next()) { ... ks.get_listvec() ... }
+
+rank()/seek(r) and the static rank()/unrank() are positions in each order, in [0, C(N,k)), N <= 64.
+***/
+
+#ifndef _KSUBSET_H_INCLUDED_
+#define _KSUBSET_H_INCLUDED_
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+#include "bitops.h"
+#include "set_adapter.h"
+#include "powerset.h"
+
+class ksubset {
+    public:
+        ksubset(size_t N, size_t K) :
+            n(N), k(K), listvec(K), bitvec(N, false), bitvec_stale(true), deltas(), previous(), last_subset(false), _done(false)
+        {
+            assert(K <= N && N <= 64);
+            for (size_t i = 0; i < k; ++i) {
+                listvec[i] = int(i);
+            }
+            deltas.reserve(2 * k);
+            previous.reserve(k);
+        }
+
+        virtual ~ksubset()
+        {
+        }
+
+        bool done() const
+        {
+            return _done;
+        }
+
+        size_t size() const
+        {
+            return n;
+        }
+
+        // the number of elements in every subset, k
+        size_t index() const
+        {
+            return k;
+        }
+
+        // number of subsets in a complete enumeration, C(N,k)
+        uint64_t count() const
+        {
+            return binomial(n, k);
+        }
+
+        const std::vector<int>& get_listvec() const
+        {
+            return listvec;
+        }
+
+        const std::vector<bool>& get_bitvec() const
+        {
+            if (bitvec_stale) {
+                set_adapter::assign_bitvec(bitvec, listvec);
+                bitvec_stale = false;
+            }
+            return bitvec;
+        }
+
+        // the elements removed from and added to the subset by the last call to next(), empty after
+        // seek() and after the step past the end
+        const std::vector<powerset_delta>& changes() const
+        {
+            return deltas;
+        }
+
+        virtual void next() = 0;
+        virtual uint64_t rank() const = 0;
+        virtual void seek(uint64_t r) = 0;
+
+        // C(n, k) from a Pascal triangle, n <= 64 (C(64, 32) is the largest entry, and fits)
+        static uint64_t binomial(size_t n, size_t k)
+        {
+            assert(n <= 64);
+            static const std::vector<uint64_t> table = pascal_triangle();
+            return k > n ? 0 : table[n * 65 + k];
+        }
+
+        // colex rank of a sorted k-subset, sum of C(a_i, i+1): shared by the colex and Gosper orders
+        static uint64_t colex_rank(const std::vector<int>& listvec)
+        {
+            uint64_t r = 0;
+            for (size_t i = 0; i < listvec.size(); ++i) {
+                r += binomial(listvec[i], i + 1);
+            }
+            return r;
+        }
+
+        static std::vector<int> colex_unrank(uint64_t r, size_t N, size_t K)
+        {
+            assert(r < binomial(N, K));
+            std::vector<int> listvec(K);
+            int x = int(N);
+            for (size_t i = K; i-- > 0; ) {
+                do {
+                    --x;
+                } while (binomial(x, i + 1) > r);
+                listvec[i] = x;
+                r -= binomial(x, i + 1);
+            }
+            return listvec;
+        }
+
+    protected:
+        size_t n;
+        size_t k;
+        std::vector<int> listvec;
+        mutable std::vector<bool> bitvec;
+        mutable bool bitvec_stale;
+        std::vector<powerset_delta> deltas;
+        std::vector<int> previous;      // the replaced tail of listvec, for changes()
+        bool last_subset;
+        bool _done;
+
+        void start_step()
+        {
+            deltas.clear();
+            bitvec_stale = true;
+        }
+
+        void assign(const std::vector<int>& v)
+        {
+            listvec = v;
+            deltas.clear();
+            bitvec_stale = true;
+            _done = false;
+        }
+
+        void record(int element, bool added)
+        {
+            powerset_delta d = {element, added};
+            deltas.push_back(d);
+        }
+
+        // records the difference between previous and listvec[from, from + previous.size()), both sorted
+        void record_replaced(size_t from)
+        {
+            size_t i = 0, j = from, end = from + previous.size();
+            while (i < previous.size() || j < end) {
+                if (j == end || (i < previous.size() && previous[i] < listvec[j])) {
+                    record(previous[i++], false);
+                } else if (i == previous.size() || listvec[j] < previous[i]) {
+                    record(listvec[j++], true);
+                } else {
+                    ++i;
+                    ++j;
+                }
+            }
+        }
+
+    private:
+        static std::vector<uint64_t> pascal_triangle()
+        {
+            std::vector<uint64_t> table(65 * 65, 0);
+            for (size_t i = 0; i <= 64; ++i) {
+                table[i * 65] = 1;
+                for (size_t j = 1; j <= i; ++j) {
+                    table[i * 65 + j] = table[(i - 1) * 65 + j - 1] + (j < i ? table[(i - 1) * 65 + j] : 0);
+                }
+            }
+            return table;
+        }
+};
+
+class ksubset_lexicographic : public ksubset {
+    public:
+        ksubset_lexicographic(size_t N, size_t K) : ksubset(N, K)
+        {
+            last_subset = count() == 1;
+        }
+
+        // increment the rightmost element that can move right, and pack the ones after it behind it
+        virtual void next()
+        {
+            start_step();
+            if (last_subset) {    // one past the end
+                _done = true;
+                return;
+            }
+            size_t i = k - 1;
+            while (listvec[i] == int(n - k + i)) {
+                --i;
+            }
+            previous.assign(listvec.begin() + i, listvec.end());
+            int x = listvec[i];
+            for (size_t j = i; j < k; ++j) {
+                listvec[j] = ++x;
+            }
+            record_replaced(i);
+            last_subset = listvec[0] == int(n - k);
+        }
+
+        // Mapping every element x to N-1-x turns lexicographic order into reverse colex order.
+        static uint64_t rank(const std::vector<int>& listvec, size_t N)
+        {
+            std::vector<int> mirrored(listvec.rbegin(), listvec.rend());
+            for (auto it = mirrored.begin(); it != mirrored.end(); ++it) {
+                *it = int(N) - 1 - *it;
+            }
+            return binomial(N, listvec.size()) - 1 - colex_rank(mirrored);
+        }
+
+        static std::vector<int> unrank(uint64_t r, size_t N, size_t K)
+        {
+            std::vector<int> listvec = colex_unrank(binomial(N, K) - 1 - r, N, K);
+            std::vector<int> mirrored(listvec.rbegin(), listvec.rend());
+            for (auto it = mirrored.begin(); it != mirrored.end(); ++it) {
+                *it = int(N) - 1 - *it;
+            }
+            return mirrored;
+        }
+
+        virtual uint64_t rank() const
+        {
+            return rank(listvec, n);
+        }
+
+        virtual void seek(uint64_t r)
+        {
+            assign(unrank(r, n, k));
+            last_subset = r == count() - 1;
+        }
+};
+
+class ksubset_colex : public ksubset {
+    public:
+        ksubset_colex(size_t N, size_t K) : ksubset(N, K)
+        {
+            last_subset = count() == 1;
+        }
+
+        // increment the leftmost element that can move right, and reset the ones before it to 0, 1, ...
+        virtual void next()
+        {
+            start_step();
+            if (last_subset) {    // one past the end
+                _done = true;
+                return;
+            }
+            size_t j = 0;
+            while (j + 1 < k && listvec[j] + 1 == listvec[j + 1]) {
+                ++j;
+            }
+            previous.assign(listvec.begin(), listvec.begin() + j + 1);
+            ++listvec[j];
+            for (size_t i = 0; i < j; ++i) {
+                listvec[i] = int(i);
+            }
+            record_replaced(0);
+            last_subset = listvec[0] == int(n - k);
+        }
+
+        static uint64_t rank(const std::vector<int>& listvec, size_t N)
+        {
+            (void) N;
+            return colex_rank(listvec);
+        }
+
+        static std::vector<int> unrank(uint64_t r, size_t N, size_t K)
+        {
+            return colex_unrank(r, N, K);
+        }
+
+        virtual uint64_t rank() const
+        {
+            return colex_rank(listvec);
+        }
+
+        virtual void seek(uint64_t r)
+        {
+            assign(colex_unrank(r, n, k));
+            last_subset = r == count() - 1;
+        }
+};
+
+// Revolving door order, Knuth TAOCP 7.2.1.3 algorithm R: the k-subsets of {0, ..., N-1} are those of
+// {0, ..., N-2}, followed by those of the (k-1)-subsets of {0, ..., N-2} in reverse order, with N-1 added.
+class ksubset_revolving_door : public ksubset {
+    public:
+        ksubset_revolving_door(size_t N, size_t K) : ksubset(N, K)
+        {
+            last_subset = count() == 1;
+        }
+
+        virtual void next()
+        {
+            start_step();
+            if (last_subset) {    // one past the end
+                _done = true;
+                return;
+            }
+            ++r;
+            last_subset = r == count() - 1;
+
+            // algorithm R, with c_j = listvec[j-1] and c_{k+1} = N
+            std::vector<int>& c = listvec;
+            if (k % 2 == 1) {
+                if (c[0] + 1 < at(1)) {
+                    swap_element(0, c[0] + 1);
+                    return;
+                }
+            } else if (c[0] > 0) {
+                swap_element(0, c[0] - 1);
+                return;
+            }
+            size_t j = 1;
+            bool try_decrease = k % 2 == 1;
+            for (;;) {
+                if (try_decrease) {
+                    if (c[j] >= int(j + 1)) {           // R4
+                        record(c[j], false);
+                        record(int(j) - 1, true);
+                        c[j] = c[j - 1];
+                        c[j - 1] = int(j) - 1;
+                        return;
+                    }
+                    ++j;
+                }
+                if (c[j] + 1 < at(j + 1)) {             // R5
+                    record(c[j - 1], false);
+                    record(c[j] + 1, true);
+                    c[j - 1] = c[j];
+                    ++c[j];
+                    return;
+                }
+                ++j;
+                try_decrease = true;
+            }
+        }
+
+        // With 1-based elements t_1 < ... < t_k, the rank is sum_i (-1)^(k-i) (C(t_i, i) - 1), Kreher and
+        // Stinson, Combinatorial Algorithms, 2.3.3.
+        static uint64_t rank(const std::vector<int>& listvec, size_t N)
+        {
+            (void) N;
+            size_t K = listvec.size();
+            uint64_t r = 0;
+            for (size_t i = K; i-- > 0; ) {
+                uint64_t term = binomial(listvec[i] + 1, i + 1) - 1;
+                if ((K - 1 - i) % 2 == 0) {
+                    r += term;
+                } else {
+                    r -= term;
+                }
+            }
+            return r;
+        }
+
+        static std::vector<int> unrank(uint64_t r, size_t N, size_t K)
+        {
+            assert(r < binomial(N, K));
+            std::vector<int> listvec(K);
+            size_t x = N;
+            for (size_t i = K; i > 0; --i) {
+                while (binomial(x, i) > r) {
+                    --x;
+                }
+                listvec[i - 1] = int(x);
+                r = binomial(x + 1, i) - r - 1;
+            }
+            return listvec;
+        }
+
+        virtual uint64_t rank() const
+        {
+            return r;
+        }
+
+        virtual void seek(uint64_t rank)
+        {
+            assign(unrank(rank, n, k));
+            r = rank;
+            last_subset = r == count() - 1;
+        }
+
+    private:
+        uint64_t r = 0;
+
+        // c_{j+1}, with the sentinel c_{k+1} = N
+        int at(size_t j) const
+        {
+            return j < k ? listvec[j] : int(n);
+        }
+
+        void swap_element(size_t j, int x)
+        {
+            record(listvec[j], false);
+            record(x, true);
+            listvec[j] = x;
+        }
+};
+
+// Colex order on the bits of a word, Gosper's hack: the next larger word with the same popcount.
+// next() is a handful of instructions, and get_word() is the subset, element i is bit i.
+class ksubset_gosper {
+    public:
+        ksubset_gosper(size_t N, size_t K) : n(N), k(K), word(K == 0 ? 0 : (uint64_t(-1) >> (64 - K))), _done(false)
+        {
+            assert(K <= N && N < 64);
+        }
+
+        bool done() const
+        {
+            return _done;
+        }
+
+        size_t size() const
+        {
+            return n;
+        }
+
+        size_t index() const
+        {
+            return k;
+        }
+
+        uint64_t count() const
+        {
+            return ksubset::binomial(n, k);
+        }
+
+        uint64_t get_word() const
+        {
+            return word;
+        }
+
+        bool contains(size_t i) const
+        {
+            return (word >> i) & 1;
+        }
+
+        void next()
+        {
+            if (word == 0) {            // k = 0, {} was the only subset
+                _done = true;
+                return;
+            }
+            uint64_t c = word & (0 - word);
+            uint64_t r = word + c;
+            word = r | (((word ^ r) >> 2) >> bitops::ctz(c));
+            _done = (word >> n) != 0;
+        }
+
+        uint64_t rank() const
+        {
+            uint64_t r = 0;
+            size_t i = 0;
+            for (uint64_t w = word; w != 0; w &= w - 1) {
+                r += ksubset::binomial(bitops::ctz(w), ++i);
+            }
+            return r;
+        }
+
+        void seek(uint64_t r)
+        {
+            std::vector<int> listvec = ksubset::colex_unrank(r, n, k);
+            word = 0;
+            for (auto it = listvec.begin(); it != listvec.end(); ++it) {
+                word |= uint64_t(1) << *it;
+            }
+            _done = false;
+        }
+
+    private:
+        size_t n;
+        size_t k;
+        uint64_t word;
+        bool _done;
+};
+
+#endif //_KSUBSET_H_INCLUDED_
@@ -1,10 +1,18 @@
 // main.cpp
 
+// build: g++ -std=c++14 -O2 main.cpp graph.cpp irregularity_search.cpp irregularity_solver.cpp -o main -pthread
+
 #include <random>
 #include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
 
 #include "graph.h"
-#include "superkiss64.h"
+#include "graph_fixtures.h"
+#include "irregularity_search.h"
+#include "irregularity_solver.h"
+#include "timer.h"
 
 /*
 int num_vertices = 21;
@@ -26,68 +34,42 @@ edge_list edges = {
 */
 
 
-int main()
+// usage: main [num_trials [num_threads [seconds]]], by default 100 trials on all the hardware threads
+// without time limit
+int main(int argc, char* argv[])
 {
 	std::random_device rd;
-	superkiss64 rng(rd(), rd(), rd());
 
-	graph Hx4p1 (17,
-				{{1,2}, {1,3}, {1,4}, {2,4}, {3,4}, {0,1}, {0,4},
-				{5,6}, {5,7}, {5,8}, {6,8}, {7,8}, {0,5}, {0,8},
-				{9,10}, {9,11}, {9,12}, {10,12}, {11,12}, {0,9}, {0,12},
-				{13,14}, {13,15}, {13,16}, {14,16}, {15,16}, {0,13}, {0,16}});
-				
-	graph k4(4, {{0,1}, {1,2}, {0,2}, {2,3}, {0,3}, {1,3}});
-	graph s_21(	21,
-				{{0,1}, {0,2}, {0,3}, {0,4}, {0,5}, {0,6}, {0,7}, {0,8}, {0,9}, {0,10},
-				{0,11}, {0,12}, {0,13}, {0,14}, {0,15}, {0,16}, {0,17}, {0,18}, {0,19}, {0,20}});
+	graph Hx4p1 = h_copies(4);
+	graph k4 = complete(4);
+	graph s_21 = star(21);
 
 	
 	//graph& g = Hx4p1;
 	//g.display(std::cout) << std::endl;
 	
-	//std::pair<int,int> ve = g.get_ve();
-
-	const int num_trials = 100;
-	int smax = 6;
-	for (int i = 1; i <= num_trials; ++i) {
-		
-		graph g = Hx4p1;
-		std::pair<int,int> ve = g.get_ve();
-		int iterations = 0;
-		
-		if (smax == 0) {
-			smax = g.get_upper_bound_on_s_G();
-		}
-		
-		for (;;) {	
-			if (g.is_irregular()) {
-				smax = g.s();
-				g.display(std::cout) << std::endl;
-				break;
-			}
-		
-			//int edge_index = (int)(rng.rand01() * ve.second);
-			int edge_index = g.compute_edge_priorities();
-			//g.display(std::cout) << std::endl;
-			
-			int weight = 0;
-			for (;;) {
-				weight = (int)(1. + rng.rand01() * smax);
-				if (weight != g.get_weight(edge_index)) {
-					break;
-				}
-			}
+	irregularity_search_options options;
+	options.num_trials = argc > 1 ? std::atoi(argv[1]) : 100;
+	options.num_threads = argc > 2 ? std::atoi(argv[2]) : 0;
+	if (argc > 3) {
+		options.max_time = std::chrono::duration_cast<timer::duration>(std::chrono::duration<double>(std::atof(argv[3])));
+	}
+	options.smax = 6;
+	options.seed = (uint64_t(rd()) << 32) ^ rd();
 
-			if (++iterations > 100) {
-				std::cout << "...aborting...";
-				break;
-			}
-			
-			//std::cout << "Assigning edge " << edge_index << " weight " << weight << std::endl;
-			g.adjust_weight(edge_index, weight);
+	irregularity_search_result result = irregularity_search(Hx4p1, options);
 
+	if (result.best_s > 0) {
+		graph g = Hx4p1;
+		for (int edge_index = 0; edge_index < int(result.best_weights.size()); ++edge_index) {
+			g.adjust_weight(edge_index, result.best_weights[edge_index]);
 		}
-		std::cout << iterations << " iterations" << std::endl;
+		g.display(std::cout) << std::endl;
 	}
+	std::cout << "s(G) = " << result.best_s << ", lower bound " << result.lower_bound << (result.best_s == result.lower_bound ? " (optimal)" : "") << std::endl;
+	std::cout << options.num_trials << " trials: " << result.num_irregular << " irregular, " << result.num_aborted << " aborted, "
+			  << result.num_pruned << " pruned, " << result.num_skipped << " skipped, in " << timer::to_milliseconds(result.elapsed) << " ms" << std::endl;
+
+	irregularity_solver_result exact = solve_irregularity_strength(Hx4p1, irregularity_solver_options());
+	std::cout << "exact: s(G) = " << exact.s << ", " << exact.nodes << " nodes in " << timer::to_milliseconds(exact.elapsed) << " ms" << std::endl;
 }
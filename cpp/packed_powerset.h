@@ -0,0 +1,268 @@
+// packed_powerset.h
+
+/***
+Packed word powerset enumerations.  The subset is kept as bits of an array of unsigned words
+(one word for N <= 64 with the default uint64_t), so that:
+
+	binary order	: next() is an increment with carry, x + 1
+	Gray code order	: next() flips bit ctz(r) of the subset, where r is the new rank
+
+Both are O(1) (amortized O(1) for the carry across words), compared to the O(N) scans of
+powerset_binary and powerset_graycode which also rebuild listvec on every step.  The vector<bool>
+and vector<int> views of powerset are still available through get_bitvec() and get_listvec(), but
+they are only materialized, in O(N), when asked for.  Use get_words() or contains(i) in tight loops.
+
+Enumeration visits {} first, and next() past the last subset sets done():
+
+	for (packed_powerset_graycode<> ps(N); !ps.done(); ps.next()) { ... }
+
+Running aggregates over the subset can be kept up to date from the change each step makes:
+
+	binary order	: carried() elements, [0, carried()), left the subset and element carried() entered it
+	Gray code order	: element flipped() entered the subset if contains(flipped()), and left it otherwise
+
+rank()/seek(r) are as in powerset.h, and need N < 64.  Gray code enumerations of N >= 64 elements
+are supported (the rank counter is 64 bits) but will never reach their end in practice.
+***/
+
+#ifndef _PACKED_POWERSET_H_INCLUDED_
+#define _PACKED_POWERSET_H_INCLUDED_
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <type_traits>
+
+#include "bitops.h"
+
+template <typename WordType = uint64_t>
+class packed_powerset {
+
+    static_assert(std::is_unsigned<WordType>::value && !std::is_same<WordType, bool>::value, "WordType must be an unsigned integer type.");
+
+    public:
+        static const size_t WORD_BITS = 8 * sizeof(WordType);
+
+        packed_powerset(size_t N) :
+            n(N), words((N + WORD_BITS - 1) / WORD_BITS + (N == 0), 0), popcount(0), last_subset(N == 0), _done(false),
+            bitvec(), listvec(), views_stale(true)
+        {
+        }
+
+        bool done() const
+        {
+            return _done;
+        }
+
+        size_t size() const
+        {
+            return n;
+        }
+
+        // the number of elements in the current subset
+        size_t index() const
+        {
+            return popcount;
+        }
+
+        uint64_t count() const
+        {
+            assert(n < 64);
+            return uint64_t(1) << n;
+        }
+
+        bool contains(size_t i) const
+        {
+            assert(i < n);
+            return (words[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+        }
+
+        const std::vector<WordType>& get_words() const
+        {
+            return words;
+        }
+
+        const std::vector<bool>& get_bitvec() const
+        {
+            materialize();
+            return bitvec;
+        }
+
+        const std::vector<int>& get_listvec() const
+        {
+            materialize();
+            return listvec;
+        }
+
+    protected:
+        size_t n;
+        std::vector<WordType> words;
+        size_t popcount;
+        bool last_subset;
+        bool _done;
+
+        // the subset as a number, requires N < 64
+        uint64_t to_uint64() const
+        {
+            assert(n < 64);
+            uint64_t x = 0;
+            for (size_t i = 0; i < words.size() && i * WORD_BITS < 64; ++i) {
+                x |= uint64_t(words[i]) << (i * WORD_BITS);
+            }
+            return x;
+        }
+
+        void assign_uint64(uint64_t x)
+        {
+            assert(n < 64);
+            for (size_t i = 0; i < words.size(); ++i) {
+                words[i] = (i * WORD_BITS < 64 ? WordType(x >> (i * WORD_BITS)) : 0);
+            }
+            popcount = bitops::popcount(x);
+            views_stale = true;
+        }
+
+        void flip(size_t i)
+        {
+            WordType mask = WordType(1) << (i % WORD_BITS);
+            WordType& w = words[i / WORD_BITS];
+            w ^= mask;
+            if (w & mask) {
+                ++popcount;
+            } else {
+                --popcount;
+            }
+            views_stale = true;
+        }
+
+        void invalidate_views()
+        {
+            views_stale = true;
+        }
+
+    private:
+        mutable std::vector<bool> bitvec;
+        mutable std::vector<int> listvec;
+        mutable bool views_stale;
+
+        void materialize() const
+        {
+            if (!views_stale) {
+                return;
+            }
+            bitvec.assign(n, false);
+            listvec.clear();
+            for (size_t i = 0; i < words.size(); ++i) {
+                WordType w = words[i];
+                while (w != 0) {
+                    int e = int(i * WORD_BITS + bitops::ctz(uint64_t(w)));
+                    bitvec[e] = true;
+                    listvec.push_back(e);
+                    w &= w - 1;
+                }
+            }
+            views_stale = false;
+        }
+};
+
+template <typename WordType = uint64_t>
+class packed_powerset_binary : public packed_powerset<WordType> {
+    typedef packed_powerset<WordType> base;
+
+    public:
+        packed_powerset_binary(size_t N) : base(N), _carried(0)
+        {
+        }
+
+        // the number of trailing ones cleared by the last next(), the bit above them was set
+        size_t carried() const
+        {
+            return _carried;
+        }
+
+        // x + 1: the trailing ones become zeros and the next zero becomes one
+        void next()
+        {
+            if (this->last_subset) {    // one past the end
+                this->_done = true;
+                return;
+            }
+            size_t i = 0;
+            size_t carried = 0;
+            while (this->words[i] == WordType(-1)) {
+                this->words[i++] = 0;
+                carried += base::WORD_BITS;
+            }
+            WordType w = this->words[i];
+            carried += bitops::ctz(uint64_t(WordType(~w)));
+            this->words[i] = w + 1;
+            _carried = carried;
+            this->popcount = this->popcount + 1 - carried;
+            this->last_subset = this->popcount == this->n;
+            this->invalidate_views();
+        }
+
+        uint64_t rank() const
+        {
+            return this->to_uint64();
+        }
+
+        void seek(uint64_t r)
+        {
+            assert(r < this->count());
+            this->assign_uint64(r);
+            this->last_subset = this->popcount == this->n;
+            this->_done = false;
+            _carried = 0;
+        }
+
+    private:
+        size_t _carried;
+};
+
+template <typename WordType = uint64_t>
+class packed_powerset_graycode : public packed_powerset<WordType> {
+    typedef packed_powerset<WordType> base;
+
+    public:
+        packed_powerset_graycode(size_t N) : base(N), r(0)
+        {
+        }
+
+        // the element flipped by the last next(), meaningless before the first step or after a seek()
+        size_t flipped() const
+        {
+            return bitops::ctz(r);
+        }
+
+        // the subset of rank r+1 differs from the subset of rank r in bit ctz(r+1)
+        void next()
+        {
+            if (this->last_subset) {    // one past the end
+                this->_done = true;
+                return;
+            }
+            ++r;
+            this->flip(bitops::ctz(r));
+            this->last_subset = this->n < 64 && r == this->count() - 1;
+        }
+
+        uint64_t rank() const
+        {
+            return r;
+        }
+
+        void seek(uint64_t rank)
+        {
+            assert(rank < this->count());
+            r = rank;
+            this->assign_uint64(r ^ (r >> 1));
+            this->last_subset = r == this->count() - 1;
+            this->_done = false;
+        }
+
+    private:
+        uint64_t r;
+};
+
+#endif //_PACKED_POWERSET_H_INCLUDED_
@@ -0,0 +1,137 @@
+// parallel_backtrack.h
+
+/***
+parallel_backtrack<ElemType, StrategyType, AccumulatorType> runs a static_backtrack search on all the
+workers of a work_stealing_pool.
+
+	split	: the top of the search tree is expanded breadth first, on the calling thread, until there
+			  are at least tasks_per_worker * num_workers() unexplored subtrees (or the tree runs out).
+			  Solutions met while splitting go to the result accumulator directly.
+	search	: every subtree is a task, searched by static_backtrack from its prefix, which is replayed
+			  into the strategy with on_push() first.  Each worker owns a copy of the strategy and of
+			  the accumulator, made once per run from the ones given to the constructor, so strategies
+			  with scratch state and accumulators need no locking.  Idle workers steal subtrees from
+			  busy ones, which evens out unbalanced trees.
+	merge	: merge(result, worker_accumulator) folds every worker's accumulator into the result, on
+			  the calling thread, which operator() returns.
+
+StrategyType and AccumulatorType are concrete, copy constructible, types meeting the requirements of
+static_backtrack, eg: a FlatStrategy<ElemType> and an Accumulator<ElemType> (declared final, their calls
+are not even virtual).  Solutions are found in no particular order, so merge should be associative
+and commutative (counts, sums, best so far, ...).  An accumulator returning search_control::stop
+only ends the subtree task it was called from.  Over-splitting costs little: a subtree task is one
+static_backtrack call on a worker's preallocated buffers.
+***/
+
+#ifndef _PARALLEL_BACKTRACK_H_INCLUDED
+#define _PARALLEL_BACKTRACK_H_INCLUDED
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+#include "static_backtrack.h"
+#include "thread_pool.h"
+
+template <typename ElemType, typename StrategyType, typename AccumulatorType>
+class parallel_backtrack {
+	public:
+		parallel_backtrack(work_stealing_pool& p, const StrategyType& strat, const AccumulatorType& accum, size_t tasks_per_worker = 16) :
+			pool(p),
+			strategy(strat),
+			accumulator(accum),
+			min_tasks(tasks_per_worker * p.num_workers()),
+			num_subtrees(0)
+		{
+		}
+
+		template <typename Merge>
+		AccumulatorType operator()(Merge merge);
+
+		// the number of subtrees the last search was split into
+		size_t num_tasks() const
+		{
+			return num_subtrees;
+		}
+
+	private:
+		work_stealing_pool&		pool;
+		StrategyType			strategy;		// prototype of the per worker strategies, also used to split
+		AccumulatorType			accumulator;	// prototype of the per worker accumulators
+		size_t					min_tasks;
+		size_t					num_subtrees;
+
+		// the prefixes of the subtrees to search, solutions met on the way go to result
+		std::vector<std::vector<ElemType>> split(AccumulatorType& result);
+};
+
+template <typename ElemType, typename StrategyType, typename AccumulatorType>
+std::vector<std::vector<ElemType>> parallel_backtrack<ElemType, StrategyType, AccumulatorType>::split(AccumulatorType& result)
+{
+	std::vector<std::vector<ElemType>> frontier(1), next;
+	candidate_buffer<ElemType> candidates;
+	candidates.reserve(1, strategy.max_branching());
+
+	while (!frontier.empty() && frontier.size() < min_tasks) {
+		next.clear();
+		for (auto it = frontier.begin(); it != frontier.end(); ++it) {
+			for (auto e = it->begin(); e != it->end(); ++e) {
+				strategy.on_push(*e);
+			}
+			candidates.clear();
+			candidates.open_level();
+			strategy.get_candidates(candidates, *it);
+			while (!candidates.is_empty()) {
+				ElemType c = candidates.take();
+				std::vector<ElemType> child(*it);
+				child.push_back(c);
+				strategy.on_push(c);
+				if (strategy.is_solution(child)) {
+					accumulate_solution(result, child, 0);
+				} else {
+					next.push_back(std::move(child));
+				}
+				strategy.on_pop(c);
+			}
+			for (auto e = it->rbegin(); e != it->rend(); ++e) {
+				strategy.on_pop(*e);
+			}
+		}
+		frontier.swap(next);
+	}
+	return frontier;
+}
+
+template <typename ElemType, typename StrategyType, typename AccumulatorType>
+template <typename Merge>
+AccumulatorType parallel_backtrack<ElemType, StrategyType, AccumulatorType>::operator()(Merge merge)
+{
+	AccumulatorType result(accumulator);
+	std::vector<std::vector<ElemType>> subtrees = split(result);
+	num_subtrees = subtrees.size();
+
+	// the engines hold references to their strategy and accumulator, which must not move afterwards
+	size_t num_workers = pool.num_workers();
+	std::vector<StrategyType> strategies(num_workers, strategy);
+	std::vector<AccumulatorType> accumulators(num_workers, accumulator);
+	typedef static_backtrack<ElemType, StrategyType, AccumulatorType> engine;
+	std::vector<std::unique_ptr<engine>> engines;
+	for (size_t w = 0; w < num_workers; ++w) {
+		engines.emplace_back(new engine(strategies[w], accumulators[w]));
+	}
+
+	for (auto it = subtrees.begin(); it != subtrees.end(); ++it) {
+		const std::vector<ElemType>* prefix = &*it;
+		pool.submit([&engines, prefix](size_t worker) {
+			(*engines[worker])(*prefix);
+		});
+	}
+	pool.wait();
+
+	for (auto it = accumulators.begin(); it != accumulators.end(); ++it) {
+		merge(result, static_cast<const AccumulatorType&>(*it));
+	}
+	return result;
+}
+
+#endif //_PARALLEL_BACKTRACK_H_INCLUDED
@@ -0,0 +1,167 @@
+// parallel_backtrack_test.cpp
+
+// build: g++ -std=c++14 -O2 parallel_backtrack_test.cpp -o parallel_backtrack_test -pthread
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "flat_backtrack.h"
+#include "parallel_backtrack.h"
+#include "timer.h"
+
+// n queens, one per row: the candidates for the next row are the columns not attacked by the queens
+// already placed, tracked incrementally with on_push/on_pop as bitmasks of the attacked columns and
+// diagonals
+class QueensStrategy final : public FlatStrategy<int> {
+	public:
+		QueensStrategy(int n) : size(n), row(0), columns(0), diagonals(0), antidiagonals(0)
+		{
+		}
+
+		int get_candidates(candidate_buffer<int>& candidates, const std::vector<int>&)
+		{
+			int num_candidates = 0;
+			for (int col = 0; col < size; ++col) {
+				if (!(columns >> col & 1) && !(diagonals >> (row + col) & 1) && !(antidiagonals >> (row - col + size) & 1)) {
+					candidates.push(col);
+					++num_candidates;
+				}
+			}
+			return num_candidates;
+		}
+
+		bool is_solution(const std::vector<int>& soln) const
+		{
+			return soln.size() == size_t(size);
+		}
+
+		void on_push(const int& col)
+		{
+			toggle(col);
+			++row;
+		}
+
+		void on_pop(const int& col)
+		{
+			--row;
+			toggle(col);
+		}
+
+		size_t max_depth() const
+		{
+			return size;
+		}
+
+		size_t max_branching() const
+		{
+			return size;
+		}
+
+	private:
+		int size;
+		int row;					// the number of queens placed
+		uint64_t columns;
+		uint64_t diagonals;			// bit row + col
+		uint64_t antidiagonals;		// bit row - col + size
+
+		void toggle(int col)
+		{
+			columns ^= uint64_t(1) << col;
+			diagonals ^= uint64_t(1) << (row + col);
+			antidiagonals ^= uint64_t(1) << (row - col + size);
+		}
+};
+
+// counts the solutions, and sums a hash of each, so that the result does not depend on their order
+class CountingAccumulator final : public Accumulator<int> {
+	public:
+		CountingAccumulator() : num_solutions(0), hash_sum(0)
+		{
+		}
+
+		void operator()(const std::vector<int>& soln)
+		{
+			++num_solutions;
+			uint64_t h = 0;
+			for (std::vector<int>::const_iterator it = soln.begin(); it != soln.end(); ++it) {
+				h = h * 1000003 + *it;
+			}
+			hash_sum += h;
+		}
+
+		static void merge(CountingAccumulator& into, const CountingAccumulator& from)
+		{
+			into.num_solutions += from.num_solutions;
+			into.hash_sum += from.hash_sum;
+		}
+
+		uint64_t num_solutions;
+		uint64_t hash_sum;
+};
+
+typedef parallel_backtrack<int, QueensStrategy, CountingAccumulator> parallel_queens;
+
+// same solutions as the sequential engine, for any number of workers and of subtrees
+int check_queens(int n, uint64_t expected, size_t num_threads, size_t tasks_per_worker)
+{
+	QueensStrategy strat(n);
+	CountingAccumulator sequential;
+	flat_backtrack<int> back(strat, sequential);
+	back();
+
+	work_stealing_pool pool(num_threads);
+	parallel_queens search(pool, strat, CountingAccumulator(), tasks_per_worker);
+	CountingAccumulator parallel = search(CountingAccumulator::merge);
+
+	int failures = 0;
+	failures += sequential.num_solutions != expected;
+	failures += parallel.num_solutions != expected;
+	failures += parallel.hash_sum != sequential.hash_sum;
+	return failures;
+}
+
+void scaling_benchmark(int n, size_t max_threads)
+{
+	std::cout << n << " queens, parallel_backtrack" << std::endl;
+	std::cout << std::setw(8) << "threads" << std::setw(10) << "tasks" << std::setw(12) << "ms" << std::setw(12) << "speedup" << std::endl;
+	double single = 0;
+	for (size_t num_threads = 1; ; num_threads = std::min(2 * num_threads, max_threads)) {
+		work_stealing_pool pool(num_threads);
+		parallel_queens search(pool, QueensStrategy(n), CountingAccumulator());
+		timer t;
+		t.start();
+		CountingAccumulator result = search(CountingAccumulator::merge);
+		double ms = timer::to_milliseconds(t.stop());
+		if (num_threads == 1) {
+			single = ms;
+		}
+		std::cout << std::setw(8) << num_threads << std::setw(10) << search.num_tasks() << std::setw(12) << ms
+				  << std::setw(12) << single / ms << "  (" << result.num_solutions << " solutions)" << std::endl;
+		if (num_threads == max_threads) {
+			break;
+		}
+	}
+}
+
+int main()
+{
+	size_t hw = std::max(2u, std::thread::hardware_concurrency());
+	const uint64_t solutions[] = {1, 0, 0, 2, 10, 4, 40, 92, 352, 724};
+
+	int failures = 0;
+	for (size_t num_threads : {size_t(1), size_t(2), hw}) {
+		for (size_t tasks_per_worker : {1, 16, 1000}) {
+			for (int n = 1; n <= 10; ++n) {
+				failures += check_queens(n, solutions[n - 1], num_threads, tasks_per_worker);
+			}
+		}
+	}
+	std::cout << failures << " failures" << std::endl;
+
+	scaling_benchmark(13, hw);
+	return failures == 0 ? 0 : 1;
+}
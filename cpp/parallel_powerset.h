@@ -0,0 +1,97 @@
+// parallel_powerset.h
+
+/***
+Parallel enumeration of the powerset of {0, ..., N-1}.  The rank space [0, 2^N) is cut into chunks
+of consecutive ranks, and the chunks run as tasks of a work_stealing_pool.  Each chunk builds its own
+generator and seek()s it directly to the first rank of the chunk, in O(N), so no chunk replays the
+enumeration from {}.  Because the rank of a subset is its position in the enumeration order, a chunk
+is a contiguous piece of the sequential enumeration for every order, including the lexicographic
+one, where a chunk is a run of whole or partial prefix subtrees.
+
+Powerset is any generator with a (size_t N) constructor, count(), seek(r) and next(): the
+powerset_binary, powerset_graycode, powerset_lexicographic classes of powerset.h and the packed
+engines of packed_powerset.h.  N must be below 64.
+
+Results are accumulated per worker, without synchronization, then merged:
+
+	Result r = parallel_powerset<packed_powerset_graycode<>>(N, pool, Result(),
+		[](const packed_powerset_graycode<>& ps, Result& acc) { ... },	// once per subset
+		[](Result& into, const Result& from) { ... });					// once per worker
+
+The visitor is called concurrently from all the workers, and must only modify its accumulator.
+The merge runs on the calling thread, in worker order, so it only has to be associative and
+commutative for the result to be independent of the scheduling.  The chunk visitor version calls
+visit(ps, num_subsets, acc) once per chunk, with ps seeked to the first subset of the chunk: it is
+the one to use when the visitor keeps running state across steps (eg: from changes()), which has to
+be initialized from the first subset of each chunk.
+
+The default number of chunks is 16 per worker, so that stealing can even out the load, with at least
+4096 subsets per chunk to keep the seek() and task overhead negligible.
+***/
+
+#ifndef _PARALLEL_POWERSET_H_INCLUDED_
+#define _PARALLEL_POWERSET_H_INCLUDED_
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+
+#include "thread_pool.h"
+
+template <typename Powerset, typename Result, typename ChunkVisitor, typename Merge>
+Result parallel_powerset_chunks(size_t N, work_stealing_pool& pool, const Result& init,
+                                ChunkVisitor visit, Merge merge, uint64_t num_chunks = 0)
+{
+    assert(N < 64);
+
+    const uint64_t count = uint64_t(1) << N;
+    const uint64_t MIN_CHUNK_SIZE = 4096;
+    if (num_chunks == 0) {
+        num_chunks = 16 * pool.num_workers();
+    }
+    num_chunks = std::max<uint64_t>(1, std::min(num_chunks, (count + MIN_CHUNK_SIZE - 1) / MIN_CHUNK_SIZE));
+
+    // padded apart, so that workers updating small accumulators do not share cache lines
+    struct worker_result {
+        Result    value;
+        char    padding[64];
+    };
+    std::vector<worker_result> per_worker(pool.num_workers(), worker_result{init, {}});
+    for (uint64_t c = 0; c < num_chunks; ++c) {
+        // equal chunks, the first count % num_chunks of them one subset longer
+        uint64_t begin = c * (count / num_chunks) + std::min(c, count % num_chunks);
+        uint64_t size = count / num_chunks + (c < count % num_chunks);
+        pool.submit([N, begin, size, &visit, &per_worker](size_t worker) {
+            Powerset ps(N);
+            ps.seek(begin);
+            visit(ps, size, per_worker[worker].value);
+        });
+    }
+    pool.wait();
+
+    Result result = init;
+    for (auto it = per_worker.begin(); it != per_worker.end(); ++it) {
+        merge(result, it->value);
+    }
+    return result;
+}
+
+template <typename Powerset, typename Result, typename Visitor, typename Merge>
+Result parallel_powerset(size_t N, work_stealing_pool& pool, const Result& init,
+                         Visitor visit, Merge merge, uint64_t num_chunks = 0)
+{
+    return parallel_powerset_chunks<Powerset>(N, pool, init,
+        [&visit](Powerset& ps, uint64_t size, Result& acc) {
+            for (uint64_t i = 0; ; ) {
+                visit(static_cast<const Powerset&>(ps), acc);
+                if (++i == size) {
+                    break;
+                }
+                ps.next();
+            }
+        },
+        merge, num_chunks);
+}
+
+#endif //_PARALLEL_POWERSET_H_INCLUDED_
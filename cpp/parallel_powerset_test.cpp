@@ -0,0 +1,140 @@
+// parallel_powerset_test.cpp
+
+// build: g++ -std=c++14 -O2 -march=native parallel_powerset_test.cpp -o parallel_powerset_test -pthread
+// usage: parallel_powerset_test [N_min N_max], the scaling benchmark runs N = 30..32 by default
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "powerset.h"
+#include "packed_powerset.h"
+#include "parallel_powerset.h"
+#include "timer.h"
+
+// The subset as a number, element i is bit i, for both generator families.
+uint64_t subset_bits(const powerset& ps)
+{
+    return powerset_binary::rank(ps.get_bitvec());
+}
+
+template <typename WordType>
+uint64_t subset_bits(const packed_powerset<WordType>& ps)
+{
+    return powerset_binary::rank(ps.get_bitvec());
+}
+
+// Every subset is visited exactly once, whatever the number of workers and chunks, and in order
+// within a chunk: each rank is visited once, and the subset visited at rank r is unrank(r).
+template <typename Powerset, typename Reference>
+int check_parallel(size_t N, work_stealing_pool& pool, uint64_t num_chunks)
+{
+    typedef std::vector<uint32_t> counts;
+    counts visits = parallel_powerset<Powerset>(N, pool, counts(size_t(1) << N, 0),
+        [](const Powerset& ps, counts& acc) {
+            uint64_t r = ps.rank();
+            if (subset_bits(ps) == powerset_binary::rank(Reference::unrank(r, ps.size()))) {
+                ++acc[r];
+            }
+        },
+        [](counts& into, const counts& from) {
+            for (size_t i = 0; i < into.size(); ++i) {
+                into[i] += from[i];
+            }
+        },
+        num_chunks);
+
+    int failures = 0;
+    for (auto it = visits.begin(); it != visits.end(); ++it) {
+        failures += *it != 1;
+    }
+    return failures;
+}
+
+template <typename Powerset, typename Reference>
+int check_orders(work_stealing_pool& pool)
+{
+    int failures = 0;
+    for (uint64_t num_chunks : {0, 1, 3, 1000}) {
+        for (size_t N : {1, 5, 13}) {
+            failures += check_parallel<Powerset, Reference>(N, pool, num_chunks);
+        }
+    }
+    return failures;
+}
+
+// The number of subsets whose weight sum is divisible by 7, with the running sum of each chunk
+// seeded from its first subset and then kept up to date from flipped().
+uint64_t count_divisible(size_t N, work_stealing_pool& pool)
+{
+    std::vector<uint64_t> weight(N);
+    for (size_t i = 0; i < N; ++i) {
+        weight[i] = i * i + 1;
+    }
+    return parallel_powerset_chunks<packed_powerset_graycode<>>(N, pool, uint64_t(0),
+        [&weight](packed_powerset_graycode<>& ps, uint64_t size, uint64_t& acc) {
+            uint64_t sum = 0;
+            const std::vector<int>& first = ps.get_listvec();
+            for (auto e = first.begin(); e != first.end(); ++e) {
+                sum += weight[*e];
+            }
+            uint64_t hits = (sum % 7 == 0);
+            for (uint64_t i = 1; i < size; ++i) {
+                ps.next();
+                size_t e = ps.flipped();
+                sum = ps.contains(e) ? sum + weight[e] : sum - weight[e];
+                hits += (sum % 7 == 0);
+            }
+            acc += hits;
+        },
+        [](uint64_t& into, uint64_t from) { into += from; });
+}
+
+void scaling_benchmark(size_t N_min, size_t N_max, size_t max_threads)
+{
+    std::cout << "subset sums divisible by 7, packed Gray code, ns per subset" << std::endl;
+    std::cout << std::setw(4) << "N" << std::setw(10) << "threads" << std::setw(12) << "ns" << std::setw(12) << "speedup" << std::endl;
+    for (size_t N = N_min; N <= N_max; ++N) {
+        double single = 0;
+        uint64_t expected = 0;
+        for (size_t num_threads = 1; ; num_threads = std::min(2 * num_threads, max_threads)) {
+            work_stealing_pool pool(num_threads);
+            timer t;
+            t.start();
+            uint64_t hits = count_divisible(N, pool);
+            double ns = timer::to_nanoseconds(t.stop()) / double(uint64_t(1) << N);
+            if (num_threads == 1) {
+                single = ns;
+                expected = hits;
+            }
+            std::cout << std::setw(4) << N << std::setw(10) << num_threads << std::setw(12) << ns
+                      << std::setw(12) << single / ns << (hits == expected ? "" : "  MISMATCH") << std::endl;
+            if (num_threads == max_threads) {
+                break;
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t hw = std::max(2u, std::thread::hardware_concurrency());
+
+    int failures = 0;
+    for (size_t num_threads : {size_t(1), size_t(2), hw}) {
+        work_stealing_pool pool(num_threads);
+        failures += check_orders<powerset_binary, powerset_binary>(pool);
+        failures += check_orders<powerset_graycode, powerset_graycode>(pool);
+        failures += check_orders<powerset_lexicographic, powerset_lexicographic>(pool);
+        failures += check_orders<packed_powerset_binary<>, powerset_binary>(pool);
+        failures += check_orders<packed_powerset_graycode<uint8_t>, powerset_graycode>(pool);
+    }
+    std::cout << failures << " failures" << std::endl;
+
+    size_t N_min = argc > 2 ? size_t(std::atoi(argv[1])) : 30;
+    size_t N_max = argc > 2 ? size_t(std::atoi(argv[2])) : 32;
+    scaling_benchmark(N_min, N_max, std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1);
+    return failures == 0 ? 0 : 1;
+}
@@ -5,9 +5,18 @@
 #define _POWERSET_H_INCLUDED_
 
 #include <vector>
+#include <cstdint>
+#include <cassert>
+#include "bitops.h"
 #include "iterator_exceptions.h"
 #include "set_adapter.h"
 
+// one element entering (added) or leaving (!added) the subset between two consecutive steps
+struct powerset_delta {
+    int element;
+    bool added;
+};
+
 class powerset {
     public:
         class iterator : public std::iterator<std::forward_iterator_tag, std::vector<bool>> {
@@ -16,7 +25,7 @@ class powerset {
                 {
                 }
 
-                iterator(const iterator& other) : ref_set(other.ref_set)
+                iterator(const iterator& other) : ref_set(other.ref_set), at_end(other.at_end)
                 {
                 }
 
@@ -59,6 +68,16 @@ class powerset {
                     iterator it(*this); operator++(); return it;
                 }
 
+                // reposition the enumeration at the subset of rank r, see powerset::seek()
+                iterator& seek(uint64_t r)
+                {
+                    if (ref_set != nullptr) {
+                        ref_set->seek(r);
+                        at_end = ref_set->done();
+                    }
+                    return *this;
+                }
+
             private:
 
                 powerset* ref_set;
@@ -76,9 +95,11 @@ class powerset {
 
         };
 
-        powerset(size_t N) : bitvec(N, false), listvec(), set_refid(0), last_subset(false), _done(false)
+        powerset(size_t N) : bitvec(N, false), listvec(), set_refid(0), last_subset(false), _done(false),
+            deltas(), bitvec_stale(false), listvec_stale(false)
         {
             listvec.reserve(bitvec.size());
+            deltas.reserve(bitvec.size() + 1);
         }
 
         virtual ~powerset()
@@ -95,16 +116,36 @@ class powerset {
             return iterator(this, true);
         }
 
+        // Each order steps one of the two representations, and the other is only brought up to date,
+        // in O(N), when it is asked for.
         const std::vector<bool>& get_bitvec() const
         {
+            if (bitvec_stale) {
+                set_adapter::assign_bitvec(bitvec, listvec);
+                bitvec_stale = false;
+            }
             return bitvec;
         }
 
         const std::vector<int>& get_listvec() const
         {
+            if (listvec_stale) {
+                set_adapter::assign_listvec(listvec, bitvec);
+                listvec_stale = false;
+            }
             return listvec;
         }
 
+        // The elements added to and removed from the subset by the last call to next(), in the order
+        // they happened.  Consumers can keep running aggregates (sums, counts, hashes) up to date in
+        // O(changes) per step, instead of rescanning the subset: the Gray code order reports exactly
+        // one change per step, the binary order the carry chain (amortized two changes per step), and
+        // the lexicographic order at most three.  Empty after seek() and after the step past the end.
+        const std::vector<powerset_delta>& changes() const
+        {
+            return deltas;
+        }
+
         virtual bool done() const
         {
             return _done;
@@ -120,15 +161,38 @@ class powerset {
             return set_refid;
         }
 
+        // number of subsets in a complete enumeration, 2^N.  Ranks require N < 64.
+        uint64_t count() const
+        {
+            assert(bitvec.size() < 64);
+            return uint64_t(1) << bitvec.size();
+        }
+
         virtual void next() = 0;
 
+        // The rank of a subset is its position in the enumeration order, from 0 for the first subset,
+        // {}, to count()-1 for the last.  rank() is the rank of the current subset.  seek(r) makes the
+        // subset of rank r current in O(N), so that independent workers can each start at their own
+        // slice of the enumeration, and step through it with next().
+        virtual uint64_t rank() const = 0;
+        virtual void seek(uint64_t r) = 0;
+
     protected:
 
-        std::vector<bool> bitvec;
-        std::vector<int> listvec;
+        mutable std::vector<bool> bitvec;
+        mutable std::vector<int> listvec;
         size_t set_refid;
         bool last_subset;
         bool _done;
+        std::vector<powerset_delta> deltas;
+        mutable bool bitvec_stale;
+        mutable bool listvec_stale;
+
+        void record(int element, bool added)
+        {
+            powerset_delta d = {element, added};
+            deltas.push_back(d);
+        }
 
 };
 
@@ -139,8 +203,45 @@ class powerset_binary : public powerset {
 
         virtual void next()
         {
+            deltas.clear();
             next_inner();
-            set_adapter::assign_listvec(listvec, bitvec);
+            listvec_stale = true;
+        }
+
+        // binary order: the rank is the subset read as a binary number, element i is bit i
+        static uint64_t rank(const std::vector<bool>& bitvec)
+        {
+            assert(bitvec.size() < 64);
+            uint64_t r = 0;
+            for (size_t i = 0; i < bitvec.size(); ++i) {
+                r |= uint64_t(bitvec[i]) << i;
+            }
+            return r;
+        }
+
+        static std::vector<bool> unrank(uint64_t r, size_t N)
+        {
+            assert(N < 64 && r < (uint64_t(1) << N));
+            std::vector<bool> bitvec(N, false);
+            for (size_t i = 0; i < N; ++i) {
+                bitvec[i] = (r >> i) & 1;
+            }
+            return bitvec;
+        }
+
+        virtual uint64_t rank() const
+        {
+            return rank(bitvec);
+        }
+
+        virtual void seek(uint64_t r)
+        {
+            bitvec = unrank(r, bitvec.size());
+            set_refid = bitops::popcount(r);
+            last_subset = set_refid == bitvec.size();
+            _done = false;
+            deltas.clear();
+            listvec_stale = true;
         }
 
     private:
@@ -153,10 +254,12 @@ class powerset_binary : public powerset {
             size_t i = 0;
             while (bitvec[i]) {
                 bitvec[i] = false;
+                record(int(i), false);
                 --set_refid;
                 ++i;
             }
             bitvec[i] = true;
+            record(int(i), true);
             ++set_refid;
             last_subset = set_refid == bitvec.size();    // have we generated the last subset?
         }
@@ -170,8 +273,40 @@ class powerset_graycode : public powerset {
 
         virtual void next()
         {
+            deltas.clear();
             next_inner();
-            set_adapter::assign_listvec(listvec, bitvec);
+            listvec_stale = true;
+        }
+
+        // reflected Gray code order: the subset of rank r is r ^ (r >> 1), so the rank is the
+        // prefix xor of the subset's bits, from the most significant down
+        static uint64_t rank(const std::vector<bool>& bitvec)
+        {
+            uint64_t r = powerset_binary::rank(bitvec);
+            for (unsigned shift = 1; shift < 64; shift <<= 1) {
+                r ^= r >> shift;
+            }
+            return r;
+        }
+
+        static std::vector<bool> unrank(uint64_t r, size_t N)
+        {
+            return powerset_binary::unrank(r ^ (r >> 1), N);
+        }
+
+        virtual uint64_t rank() const
+        {
+            return rank(bitvec);
+        }
+
+        virtual void seek(uint64_t r)
+        {
+            bitvec = unrank(r, bitvec.size());
+            set_refid = bitops::popcount(r ^ (r >> 1));
+            last_subset = (set_refid == 1 && bitvec[bitvec.size() - 1]);
+            _done = false;
+            deltas.clear();
+            listvec_stale = true;
         }
 
     private:
@@ -188,6 +323,7 @@ class powerset_graycode : public powerset {
                 } while (!bitvec[j-1]);
             }
             bitvec[j] = !bitvec[j];
+            record(int(j), bitvec[j]);
             set_refid += 2 * bitvec[j] - 1;
             last_subset = (set_refid == 1 && bitvec[bitvec.size() - 1]);    // have we generated the last subset?
         }        
@@ -195,58 +331,140 @@ class powerset_graycode : public powerset {
 
 class powerset_lexicographic : public powerset {
     public:
-        powerset_lexicographic(size_t N) : powerset(N), n(N), jump_over_supersets(false), started(false)
+        powerset_lexicographic(size_t N) : powerset(N), n(N), jump_over_supersets(false), skip_next(false), started(false)
         {
             listvec.reserve(n);
         }
 
-        powerset_lexicographic(size_t N, const std::vector<int>& v, bool jump = false) : powerset(N), n(N), jump_over_supersets(jump), started(false)
+        powerset_lexicographic(size_t N, const std::vector<int>& v, bool jump = false) : powerset(N), n(N), jump_over_supersets(jump), skip_next(false), started(false)
         {
             set_refid = v.size();
             listvec.resize(v.size());
             std::copy(v.begin(), v.end(), listvec.begin());
+            bitvec_stale = true;
         }
 
         virtual void next()
         {
+            deltas.clear();
             next_inner();
-            set_adapter::assign_bitvec(bitvec, listvec);
+            bitvec_stale = true;
             _done = started && set_refid == 0;        // one past the end, in this case {}
         }
 
+        // The next call to next() jumps over the supersets of the current subset that extend it, ie: over
+        // its subtree, and goes to its next sibling (or to an ancestor's).  This is jump_over_supersets for
+        // a single step, which is what a search needs to prune the subtree of a rejected subset.
+        void skip_supersets()
+        {
+            skip_next = true;
+        }
+
+        // Lexicographic order is a preorder walk of the tree whose root is {}, and where the children of
+        // a subset ending in a are the subsets extended by a+1, ..., N-1.  The subtree below a subset
+        // ending in b holds 2^(N-1-b) subsets, so a subset's rank is the number of subtrees skipped on
+        // the way down from the root, plus one for every element taken.  The rank is always the position
+        // in the complete enumeration, also when the enumeration jumps over supersets.
+        static uint64_t rank(const std::vector<int>& listvec, size_t N)
+        {
+            assert(N < 64);
+            uint64_t r = 0;
+            int b = 0;
+            for (auto it = listvec.begin(); it != listvec.end(); ++it) {
+                for (; b < *it; ++b) {
+                    r += uint64_t(1) << (N - 1 - b);
+                }
+                r += 1;
+                b = *it + 1;
+            }
+            return r;
+        }
+
+        static std::vector<int> unrank_listvec(uint64_t r, size_t N)
+        {
+            assert(N < 64 && r < (uint64_t(1) << N));
+            std::vector<int> listvec;
+            for (size_t b = 0; r > 0; ++b) {
+                uint64_t subtree = uint64_t(1) << (N - 1 - b);
+                if (r <= subtree) {
+                    listvec.push_back(int(b));
+                    r -= 1;
+                } else {
+                    r -= subtree;
+                }
+            }
+            return listvec;
+        }
+
+        static uint64_t rank(const std::vector<bool>& bitvec)
+        {
+            return rank(set_adapter::to_listvec(bitvec), bitvec.size());
+        }
+
+        static std::vector<bool> unrank(uint64_t r, size_t N)
+        {
+            return set_adapter::to_bitvec(unrank_listvec(r, N), N);
+        }
+
+        virtual uint64_t rank() const
+        {
+            return rank(listvec, n);
+        }
+
+        virtual void seek(uint64_t r)
+        {
+            listvec = unrank_listvec(r, n);
+            set_refid = listvec.size();
+            started = false;
+            skip_next = false;
+            _done = false;
+            deltas.clear();
+            bitvec_stale = true;
+        }
+
     private:
         void next_inner()
         {
             started = true;
+            bool jump = jump_over_supersets || skip_next;
+            skip_next = false;
             size_t is = 0;
             if (set_refid == 0) {
-                if (jump_over_supersets) return;
+                if (jump) return;
                 else {
                     ++set_refid;
                     listvec.push_back(-1);
                 }
                 listvec.back() = is;
+                record(int(is), true);
                 return;
             }
             if (listvec.back() != n-1) {
                 is = listvec.back() + 1;
-                if (!jump_over_supersets) {
+                if (!jump) {
                     ++set_refid;
                     listvec.push_back(-1);
+                } else {
+                    record(listvec.back(), false);
                 }
                 listvec.back() = is;
+                record(int(is), true);
                 return;
             }
             --set_refid;
+            record(listvec.back(), false);
             listvec.pop_back();
             if (set_refid == 0) return;
             is = listvec.back() + 1;
+            record(listvec.back(), false);
             listvec.back() = is;
+            record(int(is), true);
         }
 
     private:
         size_t n;
         bool jump_over_supersets;
+        bool skip_next;
         bool started;
 };
 
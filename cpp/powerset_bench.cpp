@@ -0,0 +1,289 @@
+// powerset_bench.cpp
+
+// build: g++ -std=c++14 -O2 -march=native powerset_bench.cpp -o powerset_bench
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "powerset.h"
+#include "packed_powerset.h"
+#include "ksubset.h"
+#include "basic_powerset.h"
+#include "subset_search.h"
+#include "timer.h"
+
+// keeps the optimizer from discarding the benchmarked work
+volatile uint64_t sink;
+
+// time a complete enumeration of a powerset (virtual hierarchy), returns ns per subset
+double time_enumeration(powerset& ps)
+{
+    timer t;
+    t.start();
+    uint64_t sum = 0;
+    for (auto it = ps.begin(); it != ps.end(); ++it) {
+        sum += (*it).index();
+    }
+    sink += sum;
+    return timer::to_nanoseconds(t.stop()) / ps.count();
+}
+
+template <typename Packed>
+double time_packed_enumeration(Packed& ps)
+{
+    timer t;
+    t.start();
+    uint64_t sum = 0;
+    for (; !ps.done(); ps.next()) {
+        sum += ps.index();
+    }
+    sink += sum;
+    return timer::to_nanoseconds(t.stop()) / ps.count();
+}
+
+// vector<bool> engines vs packed word engines
+void bench_packed(size_t N)
+{
+    powerset_binary binary(N);
+    packed_powerset_binary<> packed_binary(N);
+    powerset_graycode graycode(N);
+    packed_powerset_graycode<> packed_graycode(N);
+
+    std::cout << "N = " << N << ", ns per subset" << std::endl;
+    std::cout << "  powerset_binary          : " << time_enumeration(binary) << std::endl;
+    std::cout << "  packed_powerset_binary   : " << time_packed_enumeration(packed_binary) << std::endl;
+    std::cout << "  powerset_graycode        : " << time_enumeration(graycode) << std::endl;
+    std::cout << "  packed_powerset_graycode : " << time_packed_enumeration(packed_graycode) << std::endl;
+}
+
+// Sum of the weights of every subset: rescanning get_listvec() at each step vs keeping a running
+// sum up to date from changes() (or from the packed engines' flipped()).
+void bench_subset_sums(size_t N)
+{
+    std::vector<uint64_t> weight(N);
+    for (size_t i = 0; i < N; ++i) {
+        weight[i] = i * i + 1;
+    }
+
+    powerset_graycode rescan(N);
+    timer t;
+    t.start();
+    uint64_t total = 0;
+    for (auto it = rescan.begin(); it != rescan.end(); ++it) {
+        const std::vector<int>& subset = (*it).get_listvec();
+        uint64_t sum = 0;
+        for (auto e = subset.begin(); e != subset.end(); ++e) {
+            sum += weight[*e];
+        }
+        total += sum;
+    }
+    double rescan_ns = timer::to_nanoseconds(t.stop()) / rescan.count();
+    sink += total;
+
+    powerset_graycode delta(N);
+    t.start();
+    total = 0;
+    uint64_t sum = 0;
+    for (auto it = delta.begin(); it != delta.end(); ++it) {
+        const std::vector<powerset_delta>& changes = (*it).changes();
+        for (auto d = changes.begin(); d != changes.end(); ++d) {
+            sum = d->added ? sum + weight[d->element] : sum - weight[d->element];
+        }
+        total += sum;
+    }
+    double delta_ns = timer::to_nanoseconds(t.stop()) / delta.count();
+    sink += total;
+
+    packed_powerset_graycode<> packed(N);
+    t.start();
+    total = 0;
+    sum = 0;
+    for (; !packed.done(); packed.next()) {
+        size_t e = packed.flipped();
+        if (packed.rank() != 0) {
+            sum = packed.contains(e) ? sum + weight[e] : sum - weight[e];
+        }
+        total += sum;
+    }
+    double packed_ns = timer::to_nanoseconds(t.stop()) / packed.count();
+    sink += total;
+
+    std::cout << "subset sums, N = " << N << ", ns per subset" << std::endl;
+    std::cout << "  rescan get_listvec()     : " << rescan_ns << std::endl;
+    std::cout << "  powerset changes()       : " << delta_ns << std::endl;
+    std::cout << "  packed flipped()         : " << packed_ns << std::endl;
+}
+
+template <typename KSubset>
+double time_ksubsets(KSubset& ks)
+{
+    timer t;
+    t.start();
+    uint64_t sum = 0;
+    for (; !ks.done(); ks.next()) {
+        sum += ks.get_listvec().back();
+    }
+    sink += sum;
+    return timer::to_nanoseconds(t.stop()) / ks.count();
+}
+
+// The k-subsets of N elements, ns per k-subset: generated directly, vs filtering a powerset
+// enumeration for its subsets of k elements.
+void bench_ksubsets(size_t N, size_t K)
+{
+    timer t;
+    t.start();
+    uint64_t sum = 0;
+    powerset_lexicographic lex(N);
+    for (auto it = lex.begin(); it != lex.end(); ++it) {
+        if ((*it).index() == K) {
+            sum += (*it).get_listvec().back();
+        }
+    }
+    double filtered_ns = timer::to_nanoseconds(t.stop()) / ksubset::binomial(N, K);
+
+    t.start();
+    packed_powerset_binary<> packed(N);
+    for (; !packed.done(); packed.next()) {
+        if (packed.index() == K) {
+            sum += packed.get_words()[0];
+        }
+    }
+    double packed_ns = timer::to_nanoseconds(t.stop()) / ksubset::binomial(N, K);
+    sink += sum;
+
+    ksubset_lexicographic ks_lex(N, K);
+    ksubset_colex ks_colex(N, K);
+    ksubset_revolving_door ks_door(N, K);
+    ksubset_gosper gosper(N, K);
+
+    std::cout << "k-subsets, N = " << N << ", k = " << K << ", ns per k-subset" << std::endl;
+    std::cout << "  filtered powerset_lexicographic : " << filtered_ns << std::endl;
+    std::cout << "  filtered packed_powerset_binary : " << packed_ns << std::endl;
+    std::cout << "  ksubset_lexicographic           : " << time_ksubsets(ks_lex) << std::endl;
+    std::cout << "  ksubset_colex                   : " << time_ksubsets(ks_colex) << std::endl;
+    std::cout << "  ksubset_revolving_door          : " << time_ksubsets(ks_door) << std::endl;
+
+    t.start();
+    sum = 0;
+    for (; !gosper.done(); gosper.next()) {
+        sum += gosper.get_word();
+    }
+    sink += sum;
+    std::cout << "  ksubset_gosper                  : " << timer::to_nanoseconds(t.stop()) / gosper.count() << std::endl;
+}
+
+// basic_powerset, stepped with next(), with range-for, and with for_each()
+template <typename Order, typename Storage>
+void time_basic(const char* name, size_t N)
+{
+    uint64_t count = uint64_t(1) << N;
+    timer t;
+    t.start();
+    uint64_t sum = 0;
+    for (basic_powerset<Order, Storage> ps(N); !ps.done(); ps.next()) {
+        sum += ps.index();
+    }
+    double next_ns = timer::to_nanoseconds(t.stop()) / count;
+
+    t.start();
+    for (auto& ps : basic_powerset<Order, Storage>(N)) {
+        sum += ps.index();
+    }
+    double range_ns = timer::to_nanoseconds(t.stop()) / count;
+
+    t.start();
+    basic_powerset<Order, Storage>(N).for_each([&sum](const Storage& subset) {
+        sum += subset.count();
+    });
+    double for_each_ns = timer::to_nanoseconds(t.stop()) / count;
+    sink += sum;
+
+    std::cout << "  " << std::left << std::setw(38) << name << std::right << std::setw(10) << next_ns
+              << std::setw(10) << range_ns << std::setw(10) << for_each_ns << std::endl;
+}
+
+// the virtual hierarchy vs the policy templates, ns per subset
+void bench_basic(size_t N)
+{
+    powerset_binary binary(N);
+    powerset_graycode graycode(N);
+    powerset_lexicographic lexicographic(N);
+
+    std::cout << "N = " << N << ", ns per subset" << std::endl;
+    std::cout << "  powerset_binary                     : " << time_enumeration(binary) << std::endl;
+    std::cout << "  powerset_graycode                   : " << time_enumeration(graycode) << std::endl;
+    std::cout << "  powerset_lexicographic              : " << time_enumeration(lexicographic) << std::endl;
+    std::cout << "  " << std::left << std::setw(38) << "basic_powerset" << std::right << std::setw(10) << "next()"
+              << std::setw(10) << "range-for" << std::setw(10) << "for_each" << std::endl;
+    time_basic<binary_order, word_storage<>>("<binary_order, word_storage>", N);
+    time_basic<graycode_order, word_storage<>>("<graycode_order, word_storage>", N);
+    time_basic<lexicographic_order, word_storage<>>("<lexicographic_order, word_storage>", N);
+    time_basic<binary_order, bitvec_storage>("<binary_order, bitvec_storage>", N);
+    time_basic<graycode_order, bitvec_storage>("<graycode_order, bitvec_storage>", N);
+    time_basic<lexicographic_order, bitvec_storage>("<lexicographic_order, bitvec_storage>", N);
+}
+
+// 0/1 knapsack over N items by pruned lexicographic search: count the subsets that fit, and find
+// the best value with a bound (the value so far plus every item that could still be added).
+void bench_pruned_search(size_t N)
+{
+    struct item_state {
+        uint64_t weight;
+        uint64_t value;
+    };
+    std::vector<uint64_t> weight(N), value(N), suffix_value(N + 1, 0);
+    uint64_t total_weight = 0;
+    for (size_t i = 0; i < N; ++i) {
+        weight[i] = (i * 7919) % 97 + 10;
+        value[i] = (i * 104729) % 89 + 5;
+        total_weight += weight[i];
+    }
+    for (size_t i = N; i-- > 0; ) {
+        suffix_value[i] = suffix_value[i + 1] + value[i];
+    }
+    const uint64_t capacity = total_weight / 16;
+    auto extend = [&](const item_state& s, int e, item_state& child) {
+        child.weight = s.weight + weight[e];
+        child.value = s.value + value[e];
+    };
+
+    pruned_subset_search<item_state> search(N);
+    timer t;
+    t.start();
+    uint64_t fits = 0;
+    search.run(item_state{0, 0}, extend, [&](const std::vector<int>&, const item_state& s) {
+        fits += s.weight <= capacity;
+        return s.weight <= capacity;
+    });
+    double count_ms = timer::to_milliseconds(t.stop());
+    std::cout << "knapsack, N = " << N << ", capacity " << capacity << std::endl;
+    std::cout << "  feasible subsets : " << fits << ", visited " << search.nodes_visited() << ", pruned "
+              << search.nodes_pruned() << ", " << count_ms << " ms" << std::endl;
+
+    t.start();
+    uint64_t best = 0;
+    search.run(item_state{0, 0}, extend, [&](const std::vector<int>& subset, const item_state& s) {
+        if (s.weight > capacity) {
+            return false;
+        }
+        best = std::max(best, s.value);
+        size_t next = subset.empty() ? 0 : subset.back() + 1;
+        return s.value + suffix_value[next] > best;
+    });
+    double best_ms = timer::to_milliseconds(t.stop());
+    std::cout << "  best value       : " << best << ", visited " << search.nodes_visited() << ", pruned "
+              << search.nodes_pruned() << ", " << best_ms << " ms" << std::endl;
+}
+
+int main()
+{
+    bench_packed(20);
+    bench_packed(24);
+    bench_subset_sums(20);
+    bench_ksubsets(24, 4);
+    bench_ksubsets(24, 12);
+    bench_basic(24);
+    bench_pruned_search(50);
+}
@@ -0,0 +1,115 @@
+// search_limits.h
+
+/***
+Early termination for the backtrack engines (backtrack.h, static_backtrack.h).
+
+	search_control	: returned by an accumulator for every solution, stop ends the search right there.
+	search_limits	: a budget of nodes (partial solutions visited) and of wall clock time, both unlimited
+					  by default.
+	search_outcome	: how a search ended: it ran to completion, the accumulator stopped it, or it ran out
+					  of nodes or of time.
+
+search_budget is what the engines keep while searching: one counter increment and one compare per node.
+The clock is only read every time_check_interval nodes, so a time limit may be overrun by that many
+nodes' worth of work.
+***/
+
+#ifndef _SEARCH_LIMITS_H_INCLUDED
+#define _SEARCH_LIMITS_H_INCLUDED
+
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+#include "timer.h"
+
+enum class search_control { proceed, stop };
+
+enum class search_outcome { complete, stopped, node_limit, time_limit };
+
+struct search_limits {
+	uint64_t			max_nodes = std::numeric_limits<uint64_t>::max();
+	timer::duration		max_time = timer::duration::max();
+};
+
+class search_budget {
+	public:
+		static const uint64_t time_check_interval = 1024;
+
+		search_budget() : limits(), visited(0), next_check(0), reason(search_outcome::complete), clock()
+		{
+		}
+
+		void start(const search_limits& l)
+		{
+			limits = l;
+			visited = 0;
+			reason = search_outcome::complete;
+			clock.start();
+			schedule();
+		}
+
+		// accounts for one more node, false once a limit is reached
+		bool spend()
+		{
+			if (visited < next_check) {
+				++visited;
+				return true;
+			}
+			return renew();
+		}
+
+		// accounts for n more nodes at once, the limits are checked by the next spend()
+		void charge(uint64_t n)
+		{
+			visited += n;
+		}
+
+		uint64_t nodes() const
+		{
+			return visited;
+		}
+
+		// the limit reached, after spend() returned false
+		search_outcome exhausted() const
+		{
+			return reason;
+		}
+
+	private:
+		search_limits	limits;
+		uint64_t		visited;
+		uint64_t		next_check;		// spend() looks at the limits only from this many nodes on
+		search_outcome	reason;
+		timer			clock;
+
+		bool timed() const
+		{
+			return limits.max_time != timer::duration::max();
+		}
+
+		void schedule()
+		{
+			next_check = limits.max_nodes;
+			if (timed()) {
+				next_check = std::min(next_check, visited + time_check_interval);
+			}
+		}
+
+		bool renew()
+		{
+			if (visited >= limits.max_nodes) {
+				reason = search_outcome::node_limit;
+				return false;
+			}
+			if (timed() && clock.elapsed() >= limits.max_time) {
+				reason = search_outcome::time_limit;
+				return false;
+			}
+			schedule();
+			++visited;
+			return true;
+		}
+};
+
+#endif //_SEARCH_LIMITS_H_INCLUDED
@@ -0,0 +1,160 @@
+// search_stats.h
+
+/***
+Statistics policies for the backtrack engines (backtrack.h, static_backtrack.h), which take one as a
+template parameter and call it at every event of the search:
+
+	start()							a search begins
+	visit(depth)					a partial solution of length depth was built
+	begin_expand(depth)				get_candidates is called on a partial solution of length depth ...
+	end_expand(depth, candidates)	... and returned that many, 0 is a dead end
+	solutions(depth, n)				n solutions of length depth were found (n > 1 in count-only mode)
+	finish()						the search ended
+
+no_search_stats does nothing, inline, so an engine instantiated with it (the default) compiles to the
+same code as before.  depth_search_stats fills a search_stats: per depth, the nodes visited, the
+candidates generated, the dead ends, the solutions and the time spent in get_candidates (two clock
+reads per expansion), plus the wall time of the whole search.  write_json and write_csv export it.
+***/
+
+#ifndef _SEARCH_STATS_H_INCLUDED
+#define _SEARCH_STATS_H_INCLUDED
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+#include "timer.h"
+
+struct search_depth_stats {
+	uint64_t			nodes = 0;			// partial solutions of this length
+	uint64_t			candidates = 0;		// generated for the next position, from partial solutions of this length
+	uint64_t			dead_ends = 0;		// partial solutions of this length without candidates
+	uint64_t			solutions = 0;		// of this length
+	timer::duration		expand_time = timer::duration(0);	// in get_candidates
+
+	search_depth_stats& operator+=(const search_depth_stats& other)
+	{
+		nodes += other.nodes;
+		candidates += other.candidates;
+		dead_ends += other.dead_ends;
+		solutions += other.solutions;
+		expand_time += other.expand_time;
+		return *this;
+	}
+};
+
+struct search_stats {
+	std::vector<search_depth_stats>	depths;		// indexed by the length of the partial solutions
+	timer::duration					elapsed = timer::duration(0);
+
+	search_depth_stats total() const
+	{
+		search_depth_stats sum;
+		for (auto it = depths.begin(); it != depths.end(); ++it) {
+			sum += *it;
+		}
+		return sum;
+	}
+
+	void clear()
+	{
+		depths.clear();
+		elapsed = timer::duration(0);
+	}
+};
+
+class no_search_stats {
+	public:
+		void start() {}
+		void visit(size_t) {}
+		void begin_expand(size_t) {}
+		void end_expand(size_t, size_t) {}
+		void solutions(size_t, uint64_t) {}
+		void finish() {}
+};
+
+class depth_search_stats {
+	public:
+		depth_search_stats() : stats(), clock(), expand_clock()
+		{
+		}
+
+		void start()
+		{
+			stats.clear();
+			clock.start();
+		}
+
+		void visit(size_t depth)
+		{
+			at(depth).nodes += 1;
+		}
+
+		void begin_expand(size_t)
+		{
+			expand_clock.start();
+		}
+
+		void end_expand(size_t depth, size_t num_candidates)
+		{
+			search_depth_stats& d = at(depth);
+			d.expand_time += expand_clock.stop();
+			d.candidates += num_candidates;
+			d.dead_ends += num_candidates == 0;
+		}
+
+		void solutions(size_t depth, uint64_t n)
+		{
+			at(depth).solutions += n;
+		}
+
+		void finish()
+		{
+			stats.elapsed = clock.stop();
+		}
+
+		// the statistics of the last search
+		const search_stats& get() const
+		{
+			return stats;
+		}
+
+	private:
+		search_stats	stats;
+		timer			clock;
+		timer			expand_clock;
+
+		search_depth_stats& at(size_t depth)
+		{
+			if (depth >= stats.depths.size()) {
+				stats.depths.resize(depth + 1);
+			}
+			return stats.depths[depth];
+		}
+};
+
+// {"elapsed_ns": ..., "depths": [{"depth": 0, "nodes": ..., ...}, ...]}
+inline void write_json(std::ostream& o, const search_stats& stats)
+{
+	o << "{\"elapsed_ns\": " << stats.elapsed.count() << ", \"depths\": [";
+	for (size_t depth = 0; depth < stats.depths.size(); ++depth) {
+		const search_depth_stats& d = stats.depths[depth];
+		o << (depth ? ", " : "") << "{\"depth\": " << depth << ", \"nodes\": " << d.nodes << ", \"candidates\": " << d.candidates
+		  << ", \"dead_ends\": " << d.dead_ends << ", \"solutions\": " << d.solutions << ", \"expand_ns\": " << d.expand_time.count() << "}";
+	}
+	o << "]}";
+}
+
+// one line per depth, after a header line
+inline void write_csv(std::ostream& o, const search_stats& stats)
+{
+	o << "depth,nodes,candidates,dead_ends,solutions,expand_ns\n";
+	for (size_t depth = 0; depth < stats.depths.size(); ++depth) {
+		const search_depth_stats& d = stats.depths[depth];
+		o << depth << "," << d.nodes << "," << d.candidates << "," << d.dead_ends << "," << d.solutions << "," << d.expand_time.count() << "\n";
+	}
+}
+
+#endif //_SEARCH_STATS_H_INCLUDED
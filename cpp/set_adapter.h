@@ -1,5 +1,10 @@
 // set_adapter.h
 
+#ifndef _SET_ADAPTER_H_INCLUDED_
+#define _SET_ADAPTER_H_INCLUDED_
+
+#include <vector>
+
 class set_adapter {
     public:
     static void assign_bitvec(std::vector<bool>& bitvec, const std::vector<int>& listvec)
@@ -34,3 +39,5 @@ class set_adapter {
         return listvec;
     }    
 };
+
+#endif //_SET_ADAPTER_H_INCLUDED_
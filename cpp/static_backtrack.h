@@ -0,0 +1,330 @@
+// static_backtrack.h
+
+/***
+static_backtrack<ElemType, StrategyType, AccumulatorType> is the flat_backtrack engine (flat_backtrack.h)
+templated directly on the strategy and accumulator types.  When those are concrete classes whose
+member functions are not virtual (or are final), every call of the search loop, get_candidates,
+is_solution, on_push/on_pop and the accumulator, is a direct call that the compiler can inline, and
+a node costs a few instructions.  flat_backtrack<ElemType> is this engine instantiated with the
+virtual interfaces, FlatStrategy<ElemType> and Accumulator<ElemType>.
+
+A strategy provides, with the meanings of FlatStrategy:
+
+	void get_candidates(candidate_buffer<ElemType>& candidates, const std::vector<ElemType>& partial_soln)
+	bool is_solution(const std::vector<ElemType>& soln) const
+	void on_push(const ElemType& elem), void on_pop(const ElemType& elem)
+	size_t max_depth() const, size_t max_branching() const
+
+(deriving from static_strategy_base<ElemType> supplies do nothing on_push/on_pop), and an accumulator
+is anything callable as accumulator(const std::vector<ElemType>& soln), or with a member
+search_control accumulate(const std::vector<ElemType>& soln), which is preferred when present and can
+stop the search (see search_limits.h).  With C++20 the requirements are checked by the
+backtrack_strategy and backtrack_accumulator concepts.
+
+All the candidates live in one contiguous candidate_buffer, used as a single stack: the candidates for
+position p sit right above the remaining candidates for positions 0..p-1, from offset level_begin[p] to
+the top.  The search only ever takes candidates from the deepest position, so when position p runs out
+of candidates the top is back at level_begin[p], and what lies below it is exactly what is left for
+position p-1.  The buffer and the solution are reserved once, from max_depth() and max_branching().
+
+StatsType is a statistics policy (search_stats.h), no_search_stats by default.
+
+count(solution_length) is the count-only mode: the candidates for the last position are counted, then
+dropped as a block, instead of being pushed, tested and handed to the accumulator one by one.
+***/
+
+#ifndef _STATIC_BACKTRACK_H_INCLUDED
+#define _STATIC_BACKTRACK_H_INCLUDED
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+#include "search_limits.h"
+#include "search_stats.h"
+
+#if __cplusplus >= 202002L
+#include <concepts>
+#endif
+
+template <typename ElemType>
+class candidate_buffer {
+	public:
+		candidate_buffer() : buffer(), level_begin()
+		{
+		}
+
+		void reserve(size_t max_depth, size_t max_branching)
+		{
+			buffer.reserve(max_depth * max_branching);
+			level_begin.reserve(max_depth + 1);
+		}
+
+		// adds a candidate for the position being extended
+		void push(const ElemType& candidate)
+		{
+			buffer.push_back(candidate);
+		}
+
+		// the number of candidates left for the deepest position
+		size_t size() const
+		{
+			return buffer.size() - level_begin.back();
+		}
+
+		bool is_empty() const
+		{
+			return buffer.size() == level_begin.back();
+		}
+
+		// the number of positions with a candidate segment
+		size_t depth() const
+		{
+			return level_begin.size();
+		}
+
+		void clear()
+		{
+			buffer.clear();
+			level_begin.clear();
+		}
+
+		// used by the engines: start a segment for the next position, drop the (empty) deepest
+		// segment, and take the top candidate of the deepest segment
+		void open_level()
+		{
+			level_begin.push_back(buffer.size());
+		}
+
+		void close_level()
+		{
+			level_begin.pop_back();
+		}
+
+		ElemType take()
+		{
+			ElemType c = buffer.back();
+			buffer.pop_back();
+			return c;
+		}
+
+		// drops all the candidates of the deepest segment
+		void discard()
+		{
+			buffer.resize(level_begin.back());
+		}
+
+	private:
+		std::vector<ElemType>	buffer;
+		std::vector<size_t>		level_begin;
+};
+
+// no-op incremental state hooks, for strategies that have no use for them
+template <typename ElemType>
+struct static_strategy_base {
+	void on_push(const ElemType&) {}
+	void on_pop(const ElemType&) {}
+};
+
+#if __cplusplus >= 202002L
+template <typename S, typename E>
+concept backtrack_strategy = requires(S& s, const S& cs, candidate_buffer<E>& candidates, const std::vector<E>& soln, const E& e) {
+	s.get_candidates(candidates, soln);
+	{ cs.is_solution(soln) } -> std::convertible_to<bool>;
+	s.on_push(e);
+	s.on_pop(e);
+	{ cs.max_depth() } -> std::convertible_to<size_t>;
+	{ cs.max_branching() } -> std::convertible_to<size_t>;
+};
+
+template <typename A, typename E>
+concept backtrack_accumulator = requires(A& a, const std::vector<E>& soln) {
+	a(soln);
+} || requires(A& a, const std::vector<E>& soln) {
+	{ a.accumulate(soln) } -> std::same_as<search_control>;
+};
+#endif
+
+// hands soln to the accumulator: through accumulate() when it has one, else through operator(),
+// which never stops the search
+template <typename AccumulatorType, typename ElemType>
+auto accumulate_solution(AccumulatorType& accumulator, const std::vector<ElemType>& soln, int) -> decltype(search_control(accumulator.accumulate(soln)))
+{
+	return accumulator.accumulate(soln);
+}
+
+template <typename AccumulatorType, typename ElemType>
+search_control accumulate_solution(AccumulatorType& accumulator, const std::vector<ElemType>& soln, long)
+{
+	accumulator(soln);
+	return search_control::proceed;
+}
+
+template <typename ElemType, typename StrategyType, typename AccumulatorType, typename StatsType = no_search_stats>
+#if __cplusplus >= 202002L
+	requires backtrack_strategy<StrategyType, ElemType> && backtrack_accumulator<AccumulatorType, ElemType>
+#endif
+class static_backtrack {
+	public:
+		static_backtrack(StrategyType& strat, AccumulatorType& accum) :
+			solution(),
+			candidates(),
+			strategy(strat),
+			accumulator(accum),
+			limits(),
+			budget(),
+			last_outcome(search_outcome::complete),
+			num_counted(0),
+			statistics()
+		{
+			solution.reserve(strategy.max_depth());
+			candidates.reserve(strategy.max_depth(), strategy.max_branching());
+		}
+
+		void set_limits(const search_limits& l)
+		{
+			limits = l;
+		}
+
+		search_outcome operator()()
+		{
+			return operator()(std::vector<ElemType>());
+		}
+
+		// searches only the subtree below prefix, ie: the solutions that extend it
+		search_outcome operator()(const std::vector<ElemType>& prefix)
+		{
+			search<false>(prefix, 0);
+			return last_outcome;
+		}
+
+		// count-only mode: the number of solutions, where the solutions are taken to be exactly the
+		// partial solutions of length solution_length (is_solution is not called)
+		uint64_t count(size_t solution_length)
+		{
+			return count(std::vector<ElemType>(), solution_length);
+		}
+
+		uint64_t count(const std::vector<ElemType>& prefix, size_t solution_length)
+		{
+			search<true>(prefix, solution_length);
+			return num_counted;
+		}
+
+		// how the last search ended, and the number of nodes it visited
+		search_outcome outcome() const
+		{
+			return last_outcome;
+		}
+
+		uint64_t nodes_visited() const
+		{
+			return budget.nodes();
+		}
+
+		// the statistics policy, which holds those of the last search
+		StatsType& stats()
+		{
+			return statistics;
+		}
+
+	private:
+		std::vector<ElemType>			solution;
+		candidate_buffer<ElemType>		candidates;
+		StrategyType&					strategy;		// to get candidates
+		AccumulatorType&				accumulator;	// to recieve solutions
+		search_limits					limits;
+		search_budget					budget;
+		search_outcome					last_outcome;
+		uint64_t						num_counted;	// solutions counted by count()
+		StatsType						statistics;
+
+		template <bool Counting>
+		void search(const std::vector<ElemType>& prefix, size_t solution_length);
+
+		// gets the candidates for the next position, in count-only mode the last position's are only counted
+		template <bool Counting>
+		void expand(size_t solution_length)
+		{
+			candidates.open_level();
+			statistics.begin_expand(solution.size());
+			strategy.get_candidates(candidates, solution);
+			statistics.end_expand(solution.size(), candidates.size());
+			if (Counting && solution.size() + 1 == solution_length) {
+				num_counted += candidates.size();
+				budget.charge(candidates.size());
+				statistics.solutions(solution_length, candidates.size());
+				candidates.discard();
+			}
+		}
+
+		void pop()
+		{
+			ElemType last = solution.back();
+			solution.pop_back();
+			strategy.on_pop(last);
+		}
+};
+
+template <typename ElemType, typename StrategyType, typename AccumulatorType, typename StatsType>
+#if __cplusplus >= 202002L
+	requires backtrack_strategy<StrategyType, ElemType> && backtrack_accumulator<AccumulatorType, ElemType>
+#endif
+template <bool Counting>
+void static_backtrack<ElemType, StrategyType, AccumulatorType, StatsType>::search(const std::vector<ElemType>& prefix, size_t solution_length)
+{
+	assert(!Counting || solution_length > prefix.size());
+	budget.start(limits);
+	last_outcome = search_outcome::complete;
+	num_counted = 0;
+	statistics.start();
+
+	solution.clear();
+	for (auto it = prefix.begin(); it != prefix.end(); ++it) {
+		solution.push_back(*it);
+		strategy.on_push(*it);
+	}
+	statistics.visit(solution.size());
+	candidates.clear();
+	expand<Counting>(solution_length);
+
+	while (candidates.depth() > 0) {
+		// INVARIANT: candidates.depth() == solution.size() - prefix.size() + 1, the deepest level is the next position
+		if (candidates.is_empty()) {
+			candidates.close_level();
+			if (solution.size() > prefix.size()) {
+				pop();
+			}
+			continue;
+		}
+
+		if (!budget.spend()) {
+			last_outcome = budget.exhausted();
+			break;
+		}
+
+		solution.push_back(candidates.take());
+		strategy.on_push(solution.back());
+		statistics.visit(solution.size());
+
+		if (!Counting && strategy.is_solution(solution)) {
+			statistics.solutions(solution.size(), 1);
+			if (accumulate_solution(accumulator, solution, 0) == search_control::stop) {
+				last_outcome = search_outcome::stopped;
+				break;
+			}
+			pop();
+		} else {
+			expand<Counting>(solution_length);
+		}
+	}
+
+	// leave the strategy as it was found
+	while (!solution.empty()) {
+		pop();
+	}
+	statistics.finish();
+}
+
+#endif //_STATIC_BACKTRACK_H_INCLUDED
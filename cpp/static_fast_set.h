@@ -0,0 +1,142 @@
+// static_fast_set.h
+
+/***
+static_fast_set<T, N> is a fast_set<T>(N) whose capacity is a compile time constant.  The elements
+and positions lists are std::arrays, so the whole set lives inline (on the stack, or inside the
+object that owns it), it never allocates, and copying it is a plain memcpy.  The index type used
+for the stored elements, positions and count is the smallest unsigned type that can hold N, ie:
+a static_fast_set<T, 21> is 43 bytes.  Requires C++17 for constexpr mutation of std::array.
+
+Let S = static_fast_set<T, N>, and n = |S|.  This container provides (all constexpr):
+
+O(1) insert(e), remove(e), and contains(e)
+O(n) enumerations (no order guarantees)
+O(1) access to unordered list of elements, consequently O(1) uniform selection
+O(2N + 1) index_type words of storage, inline
+***/
+
+#ifndef _STATIC_FAST_SET_INCLUDED_
+#define _STATIC_FAST_SET_INCLUDED_
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <type_traits>
+
+// the smallest unsigned type that can hold every value in [0,N], with one value to spare for NO_VALUE
+template <std::size_t N>
+struct smallest_index_type {
+	typedef typename std::conditional<(N < 0xFFull), uint8_t,
+			typename std::conditional<(N < 0xFFFFull), uint16_t,
+			typename std::conditional<(N < 0xFFFFFFFFull), uint32_t, uint64_t>::type>::type>::type type;
+};
+
+template <typename UnsignedIntType, std::size_t N>
+class static_fast_set {
+
+	static_assert(std::is_unsigned<UnsignedIntType>::value, "Template parameter must be unsigned.");
+	static_assert(!std::is_same<UnsignedIntType, bool>::value, "Template parameter must not be bool.");
+	static_assert(N > 0, "Capacity must be positive.");
+
+	public:
+		typedef typename smallest_index_type<N>::type index_type;
+		typedef typename std::array<index_type, N>::const_iterator const_iterator;
+		typedef UnsignedIntType element_type;
+
+		constexpr const_iterator cbegin() const
+		{
+			return _elements.cbegin();
+		}
+
+		constexpr const_iterator cend() const
+		{
+			return _elements.cbegin() + _num_elements;
+		}
+
+		constexpr static_fast_set() :
+			_elements(),
+			_positions(),
+			_num_elements(0)
+		{
+			for (std::size_t i = 0; i < N; ++i) {
+				_positions[i] = NO_VALUE;
+			}
+		}
+
+		constexpr bool insert(UnsignedIntType element)
+		{
+			assert(element < N);
+
+			if (_positions[element] != NO_VALUE) {
+				return false;
+			}
+			_positions[element] = _num_elements;
+			_elements[_num_elements++] = index_type(element);
+			return true;
+		}
+
+		constexpr bool remove(UnsignedIntType element)
+		{
+			assert(element < N);
+
+			index_type remove_pos = _positions[element];
+			if (remove_pos == NO_VALUE) {
+				return false;
+			}
+			// move the last element into the hole, as fast_set::remove does.  Unlike fast_set, which leaves
+			// positions stale and validates them against the elements list, positions here hold NO_VALUE
+			// for absent elements (there is no O(1) clear() to keep stale entries for), so contains() is a
+			// single load.  Clearing the removed element's position last also covers element == last_element.
+			index_type last_element = _elements[--_num_elements];
+			_positions[last_element] = remove_pos;
+			_elements[remove_pos] = last_element;
+			_positions[element] = NO_VALUE;
+			return true;
+		}
+
+		constexpr bool contains(UnsignedIntType element) const
+		{
+			assert(element < N);
+
+			return _positions[element] != NO_VALUE;
+		}
+
+		constexpr bool is_empty() const
+		{
+			return _num_elements == 0;
+		}
+
+		constexpr uint64_t size() const
+		{
+			return _num_elements;
+		}
+
+		constexpr UnsignedIntType operator[](std::size_t i) const
+		{
+			assert(i < _num_elements);
+
+			return UnsignedIntType(_elements[i]);
+		}
+
+		constexpr UnsignedIntType uniform_select(double p) const
+		{
+			assert(p >= 0.0 && p < 1.0);
+
+			return UnsignedIntType(_elements[std::size_t(p * _num_elements)]);
+		}
+
+		static constexpr uint64_t capacity()
+		{
+			return N;
+		}
+
+	private:
+		std::array<index_type, N>	_elements;
+		std::array<index_type, N>	_positions;
+		index_type					_num_elements;
+
+		static constexpr index_type NO_VALUE = index_type(-1);
+};
+
+#endif //_STATIC_FAST_SET_INCLUDED_
@@ -0,0 +1,94 @@
+// static_fast_set_test.cpp
+
+// build: g++ -std=c++17 -O2 static_fast_set_test.cpp -o static_fast_set_test
+
+#include <iostream>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "static_fast_set.h"
+#include "superkiss64.h"
+
+// static_fast_set is usable in constant expressions
+constexpr static_fast_set<uint8_t, 21> make_small_set()
+{
+	static_fast_set<uint8_t, 21> s;
+	s.insert(3);
+	s.insert(7);
+	s.insert(20);
+	s.remove(3);
+	return s;
+}
+static_assert(make_small_set().contains(7) && !make_small_set().contains(3) && make_small_set().size() == 2, "constexpr static_fast_set");
+static_assert(std::is_trivially_copyable<static_fast_set<uint8_t, 21>>::value, "static_fast_set should copy with memcpy");
+
+// whether set holds exactly the elements of expected: contains(), size(), the iteration and operator[]
+template <typename Set>
+bool agrees(const Set& set, const std::set<typename Set::element_type>& expected)
+{
+	typedef typename Set::element_type T;
+	if (set.size() != expected.size() || set.is_empty() != expected.empty()) {
+		return false;
+	}
+	for (uint64_t e = 0; e < Set::capacity(); ++e) {
+		if (set.contains(T(e)) != (expected.count(T(e)) > 0)) {
+			return false;
+		}
+	}
+	std::vector<T> iterated(set.cbegin(), set.cend());
+	std::vector<T> indexed;
+	for (size_t i = 0; i < set.size(); ++i) {
+		indexed.push_back(set[i]);
+	}
+	std::sort(iterated.begin(), iterated.end());
+	std::sort(indexed.begin(), indexed.end());
+	return iterated == std::vector<T>(expected.begin(), expected.end()) && indexed == iterated;
+}
+
+// random inserts and removals against std::set, including removing the last listed element and
+// emptying the set, with a copy checked along the way
+template <typename T, std::size_t N>
+int check_random(superkiss64& rng)
+{
+	int failures = 0;
+	static_fast_set<T, N> set;
+	std::set<T> mirror;
+	failures += !agrees(set, mirror);
+	for (int step = 0; step < 5000; ++step) {
+		T e = T(rng.rand() % N);
+		if (rng.rand() % 3 != 0) {
+			failures += set.insert(e) != mirror.insert(e).second;
+		} else {
+			failures += set.remove(e) != (mirror.erase(e) > 0);
+		}
+		if (step % 7 == 0 && !set.is_empty()) {
+			T last = set[set.size() - 1];
+			failures += !set.remove(last);
+			mirror.erase(last);
+		}
+		if (step % 50 == 0) {
+			static_fast_set<T, N> copy = set;
+			failures += !agrees(copy, mirror);
+		}
+		failures += !agrees(set, mirror);
+	}
+	for (uint64_t e = 0; e < N; ++e) {
+		set.remove(T(e));
+	}
+	failures += !agrees(set, std::set<T>());
+	return failures;
+}
+
+int main()
+{
+	superkiss64 rng;
+	int failures = 0;
+	failures += check_random<uint8_t, 1>(rng);
+	failures += check_random<uint8_t, 21>(rng);
+	failures += check_random<uint8_t, 255>(rng);		// index_type uint16_t, to spare NO_VALUE
+	failures += check_random<uint16_t, 1000>(rng);
+	std::cout << failures << " failures" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+// subset_search.h
+
+/***
+pruned_subset_search<State>(N) is a branch-and-bound search over the subsets of {0, ..., N-1}, driven by
+powerset_lexicographic.  Lexicographic order is a preorder walk of the subset tree, where the children
+of a subset S are S extended by one element larger than max(S), so the subtree of S holds exactly the
+supersets of S that extend it.  Every subset generated is offered to a user predicate, and when the
+predicate rejects it, its whole subtree is skipped with powerset_lexicographic::skip_supersets().
+
+Each subset carries a State, computed incrementally from the state of its parent (the subset minus
+its largest element) when the subset is generated:
+
+	extend(const State& parent, int element, State& child)		: child = parent + element, eg: sums
+	accept(const std::vector<int>& subset, const State& state)	: true to keep searching below subset,
+																  false to prune its subtree
+
+A lexicographic step only ever changes the last element of the subset, so the states of all the
+proper prefixes are still valid, and a stack of N+1 states indexed by subset size is enough.  The
+predicate sees {}, with the initial state, first.  When it is monotone (a subset is rejected whenever
+one of its subsets is, eg: a weight budget), accept() is called exactly on the feasible subsets plus
+the rejected children of feasible subsets, and the search is output sensitive instead of O(2^N).
+
+	pruned_subset_search<uint64_t> search(N);
+	search.run(uint64_t(0),
+		[&](const uint64_t& w, int e, uint64_t& child) { child = w + weight[e]; },
+		[&](const std::vector<int>& subset, const uint64_t& w) { return w <= capacity; });
+
+nodes_visited() counts the calls to accept() of the last run(), and nodes_pruned() the rejections.
+***/
+
+#ifndef _SUBSET_SEARCH_H_INCLUDED_
+#define _SUBSET_SEARCH_H_INCLUDED_
+
+#include <vector>
+#include <cstdint>
+
+#include "powerset.h"
+
+template <typename State>
+class pruned_subset_search {
+    public:
+        pruned_subset_search(size_t N) : n(N), visited(0), pruned(0)
+        {
+        }
+
+        template <typename Extend, typename Accept>
+        void run(const State& initial, Extend extend, Accept accept)
+        {
+            visited = 0;
+            pruned = 0;
+            std::vector<State> states(n + 1, initial);
+            if (n == 0) {                   // {} is the only subset
+                ++visited;
+                pruned += !accept(std::vector<int>(), static_cast<const State&>(states[0]));
+                return;
+            }
+            powerset_lexicographic ps(n);
+            const std::vector<int>& subset = ps.get_listvec();
+            for (;;) {
+                size_t k = subset.size();
+                if (k > 0) {
+                    extend(static_cast<const State&>(states[k - 1]), subset.back(), states[k]);
+                }
+                ++visited;
+                if (!accept(subset, static_cast<const State&>(states[k]))) {
+                    ++pruned;
+                    ps.skip_supersets();
+                }
+                ps.next();
+                if (ps.done()) {
+                    break;
+                }
+            }
+        }
+
+        size_t size() const
+        {
+            return n;
+        }
+
+        uint64_t nodes_visited() const
+        {
+            return visited;
+        }
+
+        uint64_t nodes_pruned() const
+        {
+            return pruned;
+        }
+
+    private:
+        size_t n;
+        uint64_t visited;
+        uint64_t pruned;
+};
+
+#endif //_SUBSET_SEARCH_H_INCLUDED_
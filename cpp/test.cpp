@@ -1,6 +1,10 @@
 #include <iostream>
 
 #include "powerset.h"
+#include "packed_powerset.h"
+#include "ksubset.h"
+#include "basic_powerset.h"
+#include "subset_search.h"
 
 std::ostream& operator<<(std::ostream& o, const std::vector<bool>& p)
 {
@@ -30,8 +34,239 @@ void enumerate_powerset(powerset& ps)
     }
 }
 
+// every order: rank() counts the steps taken, unrank() agrees with the enumeration, and an
+// enumeration resumed with seek(r) visits the same subsets as the one stepped there from {}
+template <typename Powerset>
+int check_rank_unrank(size_t N)
+{
+    int failures = 0;
+    Powerset ps(N);
+    std::vector<std::vector<bool>> visited;
+    for (auto it = ps.begin(); it != ps.end(); ++it) {
+        failures += (*it).rank() != visited.size();
+        failures += Powerset::unrank(visited.size(), N) != (*it).get_bitvec();
+        failures += Powerset::rank((*it).get_bitvec()) != visited.size();
+        visited.push_back((*it).get_bitvec());
+    }
+    failures += visited.size() != ps.count();
+    for (uint64_t r = 0; r < visited.size(); ++r) {
+        Powerset resumed(N);
+        uint64_t i = r;
+        for (auto it = resumed.begin().seek(r); it != resumed.end(); ++it) {
+            failures += (*it).get_bitvec() != visited[i++];
+            failures += set_adapter::to_listvec((*it).get_bitvec()) != (*it).get_listvec();
+        }
+        failures += i != visited.size();
+    }
+    return failures;
+}
+
+// the packed engines visit the same subsets, in the same order, as their vector<bool> counterparts
+template <typename Packed, typename Reference>
+int check_packed(size_t N)
+{
+    int failures = 0;
+    Packed packed(N);
+    Reference reference(N);
+    for (auto it = reference.begin(); it != reference.end(); ++it, packed.next()) {
+        failures += packed.done();
+        failures += packed.get_bitvec() != (*it).get_bitvec();
+        failures += packed.get_listvec() != (*it).get_listvec();
+        failures += packed.index() != set_adapter::to_listvec((*it).get_bitvec()).size();
+        if (N < 64) {
+            failures += packed.rank() != (*it).rank();
+        }
+    }
+    failures += !packed.done();
+    return failures;
+}
+
+// replaying changes() onto the previous subset gives the current one, for the vector<bool> engines
+// and for the carried()/flipped() steps of the packed engines
+template <typename Powerset>
+int check_changes(Powerset& ps)
+{
+    int failures = 0;
+    std::vector<bool> replay = ps.get_bitvec();
+    for (ps.next(); !ps.done(); ps.next()) {
+        for (auto it = ps.changes().begin(); it != ps.changes().end(); ++it) {
+            failures += replay[it->element] == it->added;
+            replay[it->element] = it->added;
+        }
+        failures += replay != ps.get_bitvec();
+        failures += ps.changes().size() > (ps.get_bitvec().size() + 1);
+    }
+    return failures;
+}
+
+int check_packed_changes(size_t N)
+{
+    int failures = 0;
+    packed_powerset_binary<> b(N);
+    std::vector<bool> replay(N, false);
+    for (b.next(); !b.done(); b.next()) {
+        for (size_t i = 0; i < b.carried(); ++i) {
+            replay[i] = false;
+        }
+        replay[b.carried()] = true;
+        failures += replay != b.get_bitvec();
+    }
+    packed_powerset_graycode<> g(N);
+    replay.assign(N, false);
+    for (g.next(); !g.done(); g.next()) {
+        replay[g.flipped()] = g.contains(g.flipped());
+        failures += replay != g.get_bitvec();
+    }
+    return failures;
+}
+
+// every k-subset order: C(N,k) sorted k-subsets, all distinct, rank() counts the steps, unrank() and
+// seek() agree with the enumeration, and changes() replays each step
+template <typename KSubset>
+int check_ksubset(size_t N, size_t K, bool minimal_change = false)
+{
+    int failures = 0;
+    std::vector<bool> seen(size_t(1) << N, false);
+    std::vector<bool> replay = set_adapter::to_bitvec(KSubset(N, K).get_listvec(), N);
+    uint64_t steps = 0;
+    for (KSubset ks(N, K); !ks.done(); ks.next(), ++steps) {
+        const std::vector<int>& subset = ks.get_listvec();
+        failures += subset.size() != K;
+        for (size_t i = 1; i < subset.size(); ++i) {
+            failures += subset[i - 1] >= subset[i];
+        }
+        uint64_t bits = powerset_binary::rank(ks.get_bitvec());
+        failures += seen[bits];
+        seen[bits] = true;
+        failures += ks.rank() != steps;
+        failures += KSubset::rank(subset, N) != steps;
+        failures += KSubset::unrank(steps, N, K) != subset;
+        KSubset resumed(N, K);
+        resumed.seek(steps);
+        failures += resumed.get_listvec() != subset;
+
+        for (auto it = ks.changes().begin(); it != ks.changes().end(); ++it) {
+            failures += replay[it->element] == it->added;
+            replay[it->element] = it->added;
+        }
+        failures += replay != ks.get_bitvec();
+        if (minimal_change && steps > 0) {
+            failures += ks.changes().size() != 2;
+        }
+    }
+    failures += steps != ksubset::binomial(N, K);
+    return failures;
+}
+
+// Gosper's hack visits the colex order
+int check_gosper(size_t N, size_t K)
+{
+    int failures = 0;
+    ksubset_colex colex(N, K);
+    ksubset_gosper gosper(N, K);
+    for (; !colex.done(); colex.next(), gosper.next()) {
+        failures += gosper.done();
+        failures += gosper.get_word() != powerset_binary::rank(colex.get_bitvec());
+        failures += gosper.rank() != colex.rank();
+        ksubset_gosper resumed(N, K);
+        resumed.seek(colex.rank());
+        failures += resumed.get_word() != gosper.get_word();
+    }
+    failures += !gosper.done();
+    return failures;
+}
+
+// basic_powerset visits the same subsets, in the same order, as the virtual hierarchy, with each of
+// its three enumeration styles
+template <typename Order, typename Storage, typename Reference>
+int check_basic(size_t N)
+{
+    int failures = 0;
+    Reference reference(N);
+    basic_powerset<Order, Storage> stepped(N);
+    for (auto it = reference.begin(); it != reference.end(); ++it, stepped.next()) {
+        failures += stepped.done();
+        failures += stepped.subset().to_bitvec() != (*it).get_bitvec();
+        failures += stepped.index() != (*it).index();
+        failures += stepped.rank() != (*it).rank();
+        basic_powerset<Order, Storage> resumed(N);
+        resumed.seek((*it).rank());
+        failures += resumed.subset().to_listvec() != (*it).get_listvec();
+    }
+    failures += !stepped.done();
+
+    Reference for_each_reference(N);
+    auto it = for_each_reference.begin();
+    basic_powerset<Order, Storage>(N).for_each([&](const Storage& subset) {
+        failures += it == for_each_reference.end() || subset.to_listvec() != (*it).get_listvec();
+        ++it;
+    });
+    failures += it != for_each_reference.end();
+
+    uint64_t visited = 0;
+    for (auto& ps : basic_powerset<Order, Storage>(N)) {
+        failures += ps.rank() != visited++;
+    }
+    failures += visited != (uint64_t(1) << N);
+    return failures;
+}
+
+template <typename Order, typename Reference>
+int check_basic_storages()
+{
+    int failures = 0;
+    for (size_t N : {1, 2, 7}) {
+        failures += check_basic<Order, word_storage<>, Reference>(N) + check_basic<Order, bitvec_storage, Reference>(N);
+    }
+    basic_powerset<Order> empty(0);     // {} only
+    empty.next();
+    failures += !empty.done();
+    failures += check_basic<Order, word_storage<uint8_t>, Reference>(11);
+    return failures;
+}
+
+// A weight budget prunes exactly the infeasible subsets: every feasible subset is accepted once, with
+// its weight carried along correctly, and the rejected ones are the infeasible children of feasible ones.
+int check_pruned_search(size_t N, uint64_t capacity)
+{
+    std::vector<uint64_t> weight(N);
+    for (size_t i = 0; i < N; ++i) {
+        weight[i] = (i * 7919) % 23 + 1;
+    }
+    uint64_t feasible = 0, infeasible_children = 0;
+    for (uint64_t x = 0; x < (uint64_t(1) << N); ++x) {
+        uint64_t w = 0;
+        for (size_t i = 0; i < N; ++i) {
+            w += ((x >> i) & 1) * weight[i];
+        }
+        uint64_t parent_weight = x == 0 ? 0 : w - weight[63 - bitops::clz(x)];
+        feasible += w <= capacity;
+        infeasible_children += w > capacity && parent_weight <= capacity;
+    }
+
+    int failures = 0;
+    uint64_t accepted = 0;
+    pruned_subset_search<uint64_t> search(N);
+    search.run(uint64_t(0),
+        [&](const uint64_t& w, int e, uint64_t& child) { child = w + weight[e]; },
+        [&](const std::vector<int>& subset, const uint64_t& w) {
+            uint64_t sum = 0;
+            for (auto it = subset.begin(); it != subset.end(); ++it) {
+                sum += weight[*it];
+            }
+            failures += sum != w;
+            accepted += w <= capacity;
+            return w <= capacity;
+        });
+    failures += accepted != feasible;
+    failures += search.nodes_pruned() != infeasible_children;
+    failures += search.nodes_visited() != feasible + infeasible_children;
+    return failures;
+}
+
 int main()
 {
+    int total_failures = 0;
     try {
         powerset_graycode g(5);
         enumerate_powerset(g);
@@ -47,9 +282,54 @@ int main()
 
         powerset_lexicographic l(5, {1,2}, true);
         enumerate_powerset(l);
+        std::cout << std::endl;
+
+        int failures = check_rank_unrank<powerset_binary>(6) + check_rank_unrank<powerset_graycode>(6) + check_rank_unrank<powerset_lexicographic>(6);
+        std::cout << "rank/unrank/seek: " << failures << " failures" << std::endl;
+        total_failures += failures;
+
+        failures = check_packed<packed_powerset_binary<>, powerset_binary>(6) + check_packed<packed_powerset_graycode<>, powerset_graycode>(6)
+            + check_packed<packed_powerset_binary<uint8_t>, powerset_binary>(19) + check_packed<packed_powerset_graycode<uint8_t>, powerset_graycode>(19);
+        std::cout << "packed powersets: " << failures << " failures" << std::endl;
+        total_failures += failures;
+
+        powerset_binary cb(6);
+        powerset_graycode cg(6);
+        powerset_lexicographic cl(6);
+        powerset_lexicographic cj(6, {1,2}, true);
+        failures = check_changes(cb) + check_changes(cg) + check_changes(cl) + check_changes(cj) + check_packed_changes(6);
+        std::cout << "changes: " << failures << " failures" << std::endl;
+        total_failures += failures;
+
+        failures = 0;
+        for (size_t N = 0; N <= 9; ++N) {
+            for (size_t K = 0; K <= N; ++K) {
+                failures += check_ksubset<ksubset_lexicographic>(N, K) + check_ksubset<ksubset_colex>(N, K)
+                    + check_ksubset<ksubset_revolving_door>(N, K, true) + check_gosper(N, K);
+            }
+        }
+        failures += ksubset::binomial(64, 32) != 1832624140942590534ull;
+        std::cout << "k-subsets: " << failures << " failures" << std::endl;
+        total_failures += failures;
+
+        failures = check_basic_storages<binary_order, powerset_binary>() + check_basic_storages<graycode_order, powerset_graycode>()
+            + check_basic_storages<lexicographic_order, powerset_lexicographic>();
+#if __cplusplus >= 202002L
+        auto pairs = basic_powerset_view<lexicographic_order>(6) | std::views::filter([](auto& ps) { return ps.index() == 2; });
+        failures += std::ranges::distance(pairs) != 15;
+#endif
+        std::cout << "basic powersets: " << failures << " failures" << std::endl;
+        total_failures += failures;
+
+        failures = check_pruned_search(0, 0) + check_pruned_search(1, 0) + check_pruned_search(12, 1000) + check_pruned_search(16, 40);
+        std::cout << "pruned search: " << failures << " failures" << std::endl;
+        total_failures += failures;
 
     } catch (const iterator_not_dereferenceable_exception& ex) {
         std::cout << "exception: " << ex.what() << std::endl;
+        return 1;
     }
 
+    std::cout << total_failures << " failures" << std::endl;
+    return total_failures == 0 ? 0 : 1;
 }
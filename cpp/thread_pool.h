@@ -0,0 +1,205 @@
+// thread_pool.h
+
+/***
+work_stealing_pool(T) runs tasks on T worker threads (T = 0 means one per hardware thread).  Each
+worker owns a deque of tasks:
+
+	submit(task)	: from outside the pool, tasks are dealt round robin to the worker deques; from
+					  inside a task, they go to the back of the calling worker's own deque
+	worker loop		: pop from the back of its own deque (most recently submitted, cache warm), and
+					  when that is empty, steal from the front of another worker's deque (oldest, ie:
+					  usually the biggest piece of remaining work)
+	wait()			: block until every submitted task has finished, then rethrow the first exception
+					  thrown by a task, if any.  Must not be called from inside a task.
+
+A task is called with the index of the worker running it, in [0, num_workers()), so that it can use
+per-worker state (accumulators, random generators, scratch buffers) without synchronization.
+
+The deques are protected by one mutex each: the tasks this pool is meant for (powerset chunks,
+backtrack subtrees, independent search trials) run for microseconds to seconds, so the locking is
+noise, and contention on a deque only happens when a worker runs dry.
+***/
+
+#ifndef _THREAD_POOL_H_INCLUDED_
+#define _THREAD_POOL_H_INCLUDED_
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <exception>
+#include <cstdint>
+
+class work_stealing_pool {
+	public:
+		typedef std::function<void(size_t)> task;
+
+		explicit work_stealing_pool(size_t num_threads = 0) :
+			_queues(),
+			_threads(),
+			_state_mutex(),
+			_work_available(),
+			_all_done(),
+			_queued(0),
+			_pending(0),
+			_next_queue(0),
+			_stopping(false),
+			_error()
+		{
+			if (num_threads == 0) {
+				num_threads = std::thread::hardware_concurrency();
+			}
+			if (num_threads == 0) {
+				num_threads = 1;
+			}
+			for (size_t i = 0; i < num_threads; ++i) {
+				_queues.emplace_back(new worker_queue());
+			}
+			for (size_t i = 0; i < num_threads; ++i) {
+				_threads.emplace_back(&work_stealing_pool::worker_loop, this, i);
+			}
+		}
+
+		work_stealing_pool(const work_stealing_pool&) = delete;
+		work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+		~work_stealing_pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_state_mutex);
+				_stopping = true;
+			}
+			_work_available.notify_all();
+			for (auto it = _threads.begin(); it != _threads.end(); ++it) {
+				it->join();
+			}
+		}
+
+		size_t num_workers() const
+		{
+			return _threads.size();
+		}
+
+		void submit(task t)
+		{
+			size_t q = current_worker();
+			if (q == NO_WORKER) {
+				q = _next_queue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+			}
+			{
+				std::lock_guard<std::mutex> lock(_queues[q]->mutex);
+				_queues[q]->tasks.push_back(std::move(t));
+			}
+			{
+				std::lock_guard<std::mutex> lock(_state_mutex);
+				++_queued;
+				++_pending;
+			}
+			_work_available.notify_one();
+		}
+
+		void wait()
+		{
+			std::unique_lock<std::mutex> lock(_state_mutex);
+			_all_done.wait(lock, [this]() { return _pending == 0; });
+			if (_error) {
+				std::exception_ptr e = _error;
+				_error = nullptr;
+				std::rethrow_exception(e);
+			}
+		}
+
+	private:
+		struct worker_queue {
+			std::mutex			mutex;
+			std::deque<task>	tasks;
+		};
+
+		static const size_t NO_WORKER = size_t(-1);
+
+		std::vector<std::unique_ptr<worker_queue>>	_queues;
+		std::vector<std::thread>					_threads;
+		std::mutex									_state_mutex;
+		std::condition_variable						_work_available;
+		std::condition_variable						_all_done;
+		uint64_t									_queued;		// in a deque, not yet taken, guarded by _state_mutex
+		uint64_t									_pending;		// submitted and not yet finished, guarded by _state_mutex
+		std::atomic<size_t>							_next_queue;
+		bool										_stopping;
+		std::exception_ptr							_error;
+
+		// the index of the worker the calling thread is, or NO_WORKER for threads outside the pool
+		size_t& worker_index() const
+		{
+			static thread_local size_t index = NO_WORKER;
+			return index;
+		}
+
+		size_t current_worker() const
+		{
+			size_t i = worker_index();
+			return (i != NO_WORKER && i < _queues.size() && std::this_thread::get_id() == _threads[i].get_id()) ? i : NO_WORKER;
+		}
+
+		bool take(size_t self, task& t)
+		{
+			{
+				worker_queue& own = *_queues[self];
+				std::lock_guard<std::mutex> lock(own.mutex);
+				if (!own.tasks.empty()) {
+					t = std::move(own.tasks.back());
+					own.tasks.pop_back();
+					return true;
+				}
+			}
+			for (size_t k = 1; k < _queues.size(); ++k) {
+				worker_queue& victim = *_queues[(self + k) % _queues.size()];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (!victim.tasks.empty()) {
+					t = std::move(victim.tasks.front());
+					victim.tasks.pop_front();
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void worker_loop(size_t self)
+		{
+			worker_index() = self;
+			for (;;) {
+				{
+					std::unique_lock<std::mutex> lock(_state_mutex);
+					_work_available.wait(lock, [this]() { return _stopping || _queued > 0; });
+					if (_queued == 0) {		// and so _stopping
+						return;
+					}
+					--_queued;				// claims one task, which is in some deque
+				}
+				task t;
+				while (!take(self, t)) {
+					// the claimed task is pushed before it is counted, so it is in a deque already
+					// unless another worker took it first and left ours for later: look again
+					std::this_thread::yield();
+				}
+				try {
+					t(self);
+				} catch (...) {
+					std::lock_guard<std::mutex> lock(_state_mutex);
+					if (!_error) {
+						_error = std::current_exception();
+					}
+				}
+				std::lock_guard<std::mutex> lock(_state_mutex);
+				if (--_pending == 0) {
+					_all_done.notify_all();
+				}
+			}
+		}
+};
+
+#endif //_THREAD_POOL_H_INCLUDED_